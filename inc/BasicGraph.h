@@ -1,23 +1,67 @@
 #pragma once
 #include "common.h"
 #include "States.h"
+#include "MappedFile.h"
+#include "MapParser.h"
+#include "HeuristicStore.h"
+#include "Snapshot.h"
+#include <memory>
+#include <array>
 
 #define WEIGHT_MAX INT_MAX/2
 
+enum heuristic_mode { MANHATTAN, SHORTEST_PATH, LANDMARK };
+
+// the type of a cell; the strings in BasicGraph::types are only kept for I/O
+enum cell_type { TRAVEL, OBSTACLE, ENDPOINT, HOME, INDUCT, EJECT, ENTRY, EXIT, MAGIC, CELL_TYPE_COUNT };
+#define CELL_TYPE_BIT(type) (1u << (type)) // for building the type sets passed to BasicGraph::has_type
+
+
+class DistanceEngine;
+
+
+// Fixed-capacity list of the (at most 5) neighbors of a location or state.
+// It lives on the stack, so iterating over neighbors does not allocate.
+template <typename T>
+class NeighborList
+{
+public:
+    void push_back(const T& item) { items[count++] = item; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    T items[5];
+    int count = 0;
+};
+
 
 class BasicGraph
 {
 public:
     vector<std::string> types;
-    unordered_map<int, vector<double>> heuristics;
+    vector<uint8_t> cell_types; // the cell_type of each location, for use in hot loops
+    HeuristicStore heuristics;
+    LandmarkHeuristic landmarks; // only for the LANDMARK mode
+    int num_of_landmarks = 16;
+    heuristic_mode heuristic = SHORTEST_PATH;
+    int num_of_threads = 1; // threads used for precomputing heuristic tables
+    double precomputing_time = 0; // wall-clock seconds spent in precompute_heuristics
+    double heuristics_loading_time = 0; // wall-clock seconds spent in load_heuristics_table
+    double map_loading_time = 0; // wall-clock seconds spent in load_map
+    size_t map_file_size = 0; // bytes read by load_map
+    uint64_t map_content_hash = 0; // hash of the map file, which keys its snapshot
+    bool loaded_from_snapshot = false;
     virtual ~BasicGraph()= default;
     string map_name;
 	virtual bool load_map(string fname) = 0;
-    list<State> get_neighbors(const State& v) const;
-    list<int> get_neighbors(int v) const;
-    list<State> get_reverse_neighbors(const State& v) const; // ignore time
+    NeighborList<State> get_neighbors(const State& v) const;
+    NeighborList<int> get_neighbors(int v) const;
+    NeighborList<State> get_reverse_neighbors(const State& v) const; // ignore time
     double get_weight(int from, int to) const; // fiducials from and to are neighbors
-    vector<vector<double> > get_weights() const {return weights; }
+    const vector<std::array<double, 5> >& get_weights() const {return weights; }
     int get_rotate_degree(int dir1, int dir2) const; // return 0 if it is 0; return 1 if it is +-90; return 2 if it is 180
 
     void print_map() const;
@@ -25,21 +69,98 @@ public:
     int get_cols() const { return cols; }
     int size() const { return rows * cols; }
 
-    bool valid_move(int loc, int dir) const {return (weights[loc][dir] < WEIGHT_MAX - 1); }
+    bool valid_move(int loc, int dir) const {return (valid_moves[loc] >> dir) & 1; }
+    void update_valid_moves(); // must be called whenever the weights change
+    bool has_integer_weights() const { return integer_weights; } // all allowed moves and waits have integer weights
+    // all allowed moves and waits have the same weight, every allowed move can be reversed,
+    // and the agents can wait wherever they can move
+    bool has_uniform_weights() const { return uniform_weights; }
+    cell_type get_type(int loc) const { return (cell_type)cell_types[loc]; }
+    bool is_type(int loc, cell_type type) const { return cell_types[loc] == type; }
+    // type_set is a bitwise OR of CELL_TYPE_BIT(type)
+    bool has_type(int loc, unsigned type_set) const { return (type_set >> cell_types[loc]) & 1u; }
+    bool is_magic(int loc) const { return cell_types[loc] == MAGIC; } // vertex collisions at Magic cells are ignored
+    static cell_type get_cell_type(const MapToken& type); // unknown types are TRAVEL
+    static const char* get_type_name(cell_type type);
     int get_Manhattan_distance(int loc1, int loc2) const;
     int move[4];
     void copy(const BasicGraph& copy);
     int get_direction(int from, int to) const;
 
-    vector<double> get_heuristic(int root_location);
-	vector<double> compute_heuristics(int root_location); // compute distances from all lacations to the root location
-	bool load_heuristics_table(std::ifstream& myfile);
-	void save_heuristics_table(string fname);
+    HeuristicView get_heuristic(int root_location); // compute the table on the first query of root_location
+	vector<int> compute_heuristics(int root_location); // compute distances from all lacations to the root location
+	void compute_heuristics(int root_location, vector<int>& distances, DistanceEngine& engine) const;
+	// compute the tables of the given root locations in parallel and store them in heuristics.
+	// Roots that already have a table are skipped, and the tables are inserted in the order of root_locations,
+	// so the result does not depend on the number of threads.
+	// In the LANDMARK mode, it builds the landmark tables instead, which cover every root location.
+	void precompute_heuristics(const vector<int>& root_locations);
+	// load the cached tables of this map from the map snapshot, or import the
+	// shortest-path tables from the text file of older versions. Return false if there is no matching file.
+	// The tables are saved with the map snapshot (see save_snapshot).
+	bool load_heuristics_table();
+	// insert the tables stored at the given offset of a mapped file, in the heuristics file format
+	bool map_heuristics(const std::shared_ptr<MappedFile>& file, size_t offset, const string& fname);
+	void write_heuristics(std::ostream& out) const;
+	bool import_heuristics_table(const string& fname);
+	bool has_hidden_location(int root_location, const vector<int>& distances) const; // see import_heuristics_table
+	string get_legacy_heuristics_table_name() const; // the text file of the shortest-path tables of older versions
+	uint64_t get_map_hash() const; // hash of the map size and edge weights, which determine the heuristic tables
+	string get_heuristic_name() const;
+
+	// The map snapshot caches the loaded map, its location lists and its heuristic tables in one binary file.
+	// It is keyed by the content hash of the map file and the rotation (and heuristic) settings, so an edited
+	// map is parsed again. load_map tries it first; preprocessing saves it once the tables are computed.
+	// It is the only file that preprocessing writes.
+	bool load_snapshot(const string& map_fname); // return false if there is no valid snapshot of the map file
+	void save_snapshot() const; // no-op if the map was loaded from its snapshot
+	string get_snapshot_name() const;
+	virtual void save_locations(SnapshotWriter& /*writer*/) const {} // save the location lists of the derived grid
+	virtual bool load_locations(SnapshotReader& /*reader*/) { return true; } // assign nothing and return false on errors
+	// the grid class that wrote the location lists, since several of them read the same map formats
+	virtual string get_grid_type() const { return "BasicGraph"; }
+
+    // helpers for load_map
+    void set_size(int rows, int cols); // set the grid size and the moves, and make all cells blocked Travel cells
+    void connect_free_cells(double move_weight); // set the weights of all moves between non-obstacle cells
+    void finish_loading(const MapParser& parser); // derive valid_moves and types, and record the loading statistics
+    void update_type_names(); // derive the type strings from cell_types
+    // read the cells of a .grid file (after its header lines) into cell_types and weights,
+    // and call on_cell(loc, type, station) for every cell. Only sorting maps have the station column.
+    template <typename OnCell>
+    void read_weighted_grid(MapParser& parser, bool with_stations, OnCell on_cell)
+    {
+        for (int loc = 0; loc < rows * cols && !parser.eof(); loc++)
+        {
+            parser.skip_fields(1, ','); // skip id
+            cell_type type = get_cell_type(parser.read_field(','));
+            MapToken station;
+            if (with_stations)
+                station = parser.read_field(',');
+            parser.skip_fields(2, ','); // skip x and y
+            for (int dir = 0; dir < 5; dir++) // read edge weights
+            {
+                double w = parser.read_double(',');
+                weights[loc][dir] = w == DBL_MAX ? WEIGHT_MAX : w;
+            }
+            parser.skip_line();
+            cell_types[loc] = type;
+            on_cell(loc, type, station);
+        }
+    }
 
     int rows;
     int cols;
-    vector<vector<double> > weights; // (directed) weighted 4-neighbor grid
-    bool consider_rotation;
+    vector<std::array<double, 5> > weights; // (directed) weighted 4-neighbor grid: 4 moves and wait per location
+    // bit dir is set if the move in direction dir (or the wait, for dir = 4) is allowed and stays on the grid
+    vector<uint8_t> valid_moves;
+    bool integer_weights = true;
+    bool uniform_weights = true;
+    bool consider_rotation = false;
+    std::shared_ptr<MappedFile> snapshot_file; // the mapped snapshot that its tables point into
+    // for computing tables on demand, created on first use and again after the weights change
+    std::shared_ptr<DistanceEngine> distance_engine;
+    DistanceEngine& get_distance_engine();
 
     std::string human_readable_loc(int loc) const
     {
@@ -6,6 +6,7 @@
 #include "WHCAStar.h"
 #include "ECBS.h"
 #include "LRAStar.h"
+#include <chrono>
 
 
 class BasicSystem
@@ -15,6 +16,7 @@ public:
 	MAPFSolver& solver;
 	bool hold_endpoints;
 	bool useDummyPaths;
+	bool prioritized_fallback = false; // try a prioritized planning sweep before LRA* when the solver fails
     int time_limit;
     int travel_time_window;
 	//string potential_function;
@@ -46,6 +48,7 @@ public:
     // I/O
     std::string outfile;
     void save_results();
+	void save_statistics() const; // save runtime statistics of the planners
 	double saving_time = 0; // time for saving results to files, in seconds
     int num_of_tasks; // number of finished tasks
 
@@ -83,9 +86,13 @@ public:
 protected:
 	bool solve_by_WHCA(vector<Path>& planned_paths,
 		const vector<State>& new_starts, const vector< vector<pair<int, int> > >& new_goal_locations);
+	// one prioritized planning sweep over all agents in index order, tried before LRA* when the solver fails.
+	// It fails if it does not finish within time_limit after start, which is when the solver started.
+	bool solve_by_prioritized_planning(vector<Path>& planned_paths, std::chrono::steady_clock::time_point start);
     bool LRA_called = false;
 
 private:
 	BasicGraph& G;
+	ReservationTable prioritized_rt; // used by solve_by_prioritized_planning, kept across calls
 };
 
@@ -0,0 +1,41 @@
+#pragma once
+#include "common.h"
+#include <cstdint>
+
+
+// Soft constraints of the reservation table, i.e., how many other agents occupy a location at a timestep.
+// Only the timesteps in [0, num_of_timesteps) are covered, and num_of_timesteps is bounded by the planning window.
+// The counts are stored location by location in one buffer, which is reused like the one of ConstraintTable.
+class ConflictAvoidanceTable
+{
+public:
+    // clear the table and cover the timesteps in [0, num_of_timesteps)
+    void reset(size_t map_size, int num_of_timesteps);
+    void clear() { reset(map_size, 0); }
+
+    int size() const { return num_of_timesteps; }
+    bool empty() const { return num_of_timesteps == 0; }
+
+    // the number of agents at the location at the timestep, 0 if the timestep is not covered
+    int get(int location, int timestep) const
+    {
+        if (timestep < 0 || timestep >= num_of_timesteps)
+            return 0;
+        return counts[location * stride + timestep];
+    }
+    void add(int location, int timestep, int delta); // delta is +1 or -1
+
+    template <typename Visitor>
+    void for_each_location(Visitor visit) const // visit(location) for every location with agents (maybe repeatedly)
+    {
+        for (size_t cell : touched)
+            visit((int)(cell / stride));
+    }
+
+private:
+    size_t map_size = 0;
+    int num_of_timesteps = 0;
+    size_t stride = 0; // the capacity in timesteps of each location
+    vector<uint16_t> counts; // location * stride + timestep -> number of agents
+    vector<size_t> touched; // cells that became non-zero since the last reset
+};
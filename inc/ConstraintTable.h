@@ -0,0 +1,67 @@
+#pragma once
+#include "common.h"
+#include <cstdint>
+
+enum constraint_table_mode { HASHED_TABLE, DENSE_TABLE };
+
+struct TimeRange
+{
+    int t_min;
+    int t_max; // exclusive
+    int owner; // the reservation that added the range, or -1 if it cannot be removed individually
+};
+typedef vector<TimeRange> TimeRanges; // in insertion order
+
+
+// Hard constraints of the reservation table, i.e., the time ranges during which a vertex or an edge is occupied.
+// Vertices and edges are numbered by ReservationTable, and all ids are smaller than num_of_ids.
+// In the HASHED mode, all ids are keys of one hash map.
+// In the DENSE mode, the ranges are stored in an array indexed by id, and each id also gets a 64-bit mask of its
+// occupied timesteps in [0, horizon), so that is_constrained is a single bit test within the planning window
+// (horizon = min(window + k_robust + 1, 64); later timesteps fall back to the ranges).
+// Only the touched ids are cleared, so a table can be reused across builds without reallocating.
+class ConstraintTable
+{
+public:
+    // set the mode and the sizes. Changing the mode or the number of ids clears the table,
+    // changing only the horizon keeps the constraints.
+    void configure(constraint_table_mode mode, size_t num_of_ids, int horizon);
+
+    void insert(size_t id, int t_min, int t_max, int owner = -1);
+    // remove the ranges of the given owner at id and append them to removed (if not nullptr)
+    void remove(size_t id, int owner, TimeRanges* removed = nullptr);
+    const TimeRanges* find(size_t id) const; // nullptr if the vertex/edge is never occupied
+    bool is_constrained(size_t id, int timestep) const;
+    int get_holding_time(size_t id) const; // the end of the last range, 0 if there is none
+
+    void clear();
+    void copy(const ConstraintTable& other); // works across modes
+    bool empty() const { return hashed.empty() && num_of_occupied == 0; }
+
+    template <typename Visitor>
+    void for_each(Visitor visit) const // visit(id, ranges) for every occupied vertex/edge
+    {
+        for (const auto& entry : hashed)
+            visit(entry.first, entry.second);
+        for (int id : touched)
+        {
+            if (!dense_ranges[id].empty())
+                visit((size_t)id, dense_ranges[id]);
+        }
+    }
+
+private:
+    constraint_table_mode mode = HASHED_TABLE;
+    size_t num_of_ids = 0;
+    int horizon = 0; // timesteps covered by dense_bits
+
+    unordered_map<size_t, TimeRanges> hashed; // HASHED mode only
+    vector<TimeRanges> dense_ranges; // id -> ranges, DENSE mode only
+    vector<uint64_t> dense_bits; // id -> bit t is set if occupied at timestep t < horizon, DENSE mode only
+    vector<int> touched; // ids that got ranges since the last clear, DENSE mode only
+    vector<bool> is_touched; // id -> in touched, DENSE mode only
+    size_t num_of_occupied = 0; // touched ids that still have ranges (remove can empty them), DENSE mode only
+
+    bool is_dense(size_t id) const { return mode == DENSE_TABLE && id < num_of_ids; }
+    void update_bits(int id); // recompute the bits of the id from its ranges
+};
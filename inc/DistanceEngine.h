@@ -0,0 +1,66 @@
+#pragma once
+#include "BasicGraph.h"
+
+
+// Computes the distances from all locations to a root location by searching backward from the root.
+// Graphs whose edges all cost 1 are searched by BFS, graphs with small integer weights by Dial's
+// bucket-based Dijkstra, and any other graph by a binary-heap Dijkstra whose distances are rounded
+// down (so that they remain admissible).
+// When rotation is considered, the search runs over <location, orientation> states, where a turn costs
+// the same as a wait, and the distance of a location is the minimum over its orientations.
+class DistanceEngine
+{
+public:
+    explicit DistanceEngine(const BasicGraph& G);
+
+    // distances[loc] is the distance from loc to root_location, or INT_MAX if loc cannot reach it
+    void compute(int root_location, vector<int>& distances);
+
+    string get_method_name() const;
+
+private:
+    enum search_method { BFS, DIAL, DIJKSTRA };
+
+    const BasicGraph& G;
+    bool consider_rotation;
+    int num_of_states;
+    search_method method;
+    int max_weight; // max edge weight, used for the number of buckets in Dial's algorithm
+
+    // reused across calls
+    vector<int> state_distances;
+    vector<int> queue;
+    vector< vector<int> > buckets;
+
+    void bfs();
+    void dial();
+    void dijkstra();
+
+    // call visit(state, weight) for every state that has an edge to the given state
+    template <typename Visit>
+    void for_each_predecessor(int state, Visit visit) const
+    {
+        if (!consider_rotation)
+        {
+            for (int dir = 0; dir < 4; dir++)
+            {
+                int prev = state - G.move[dir];
+                if (prev < 0 || prev >= G.size() || !G.valid_move(prev, dir))
+                    continue;
+                visit(prev, G.weights[prev][dir]);
+            }
+            return;
+        }
+        int location = state >> 2;
+        int orientation = state & 3;
+        int prev = location - G.move[orientation];
+        if (prev >= 0 && prev < G.size() && G.valid_move(prev, orientation)) // move forward
+            visit(prev * 4 + orientation, G.weights[prev][orientation]);
+        double turn_weight = G.weights[location][4];
+        if (turn_weight < WEIGHT_MAX - 1) // turn left or right
+        {
+            visit(location * 4 + ((orientation + 1) & 3), turn_weight);
+            visit(location * 4 + ((orientation + 3) & 3), turn_weight);
+        }
+    }
+};
@@ -1,7 +1,8 @@
 #pragma once
 #include "ECBSNode.h"
 #include "MAPFSolver.h"
-#include <ctime>
+#include "PlannerPool.h"
+#include <chrono>
 
 class ECBS :
 	public MAPFSolver
@@ -13,6 +14,7 @@ public:
 	string potential_function;
 	double potential_threshold;
 	double suboptimal_bound;
+	int planner_threads = 1; // threads for the low-level searches of the two children of a split
 
 
     ECBSNode* dummy_start;
@@ -57,7 +59,11 @@ private:
     std::vector<double> path_min_costs;
     std::vector<double> path_costs;
 
-    std::clock_t start;
+    std::chrono::steady_clock::time_point start;
+
+    std::unique_ptr<PlannerPool> planner_pool; // nullptr if planner_threads is 1
+    ReservationTable child_rt; // the table of the second child in concurrent splits
+    ReservationTable split_rt; // the reservations shared by both children in concurrent splits
 
     double min_f_val;
     double focal_threshold;
@@ -74,6 +80,12 @@ private:
 
     // high level search
     bool find_path(ECBSNode*  node, int ag);
+    void collect_constraints(ECBSNode* node, int agent, list<Constraint>& constraints) const;
+    bool replace_path(ECBSNode* node, int agent, const list<Constraint>& constraints,
+                     Path& path, double min_f_val, double path_cost);
+    bool find_paths_concurrently(ECBSNode* children[2], list<Constraint> constraints[2],
+                                 vector<PlannerPool::Query>& queries);
+    void finish_child(ECBSNode* node, const list<int>& to_replan); // find the conflicts and the costs
     void resolve_conflict(const Conflict& conflict, ECBSNode* n1, ECBSNode* n2);
     bool generate_child(ECBSNode* child, ECBSNode* curr);
 
@@ -0,0 +1,113 @@
+#pragma once
+#include "common.h"
+#include <cstdint>
+#include "LandmarkHeuristic.h"
+
+
+// The heuristic table of one root location, i.e., the distances from all locations to the root location.
+// Tables computed by this process own their values and are stored in 16 bits per location when all
+// distances fit (and 32 bits otherwise). Tables loaded from a heuristics file point into the memory-mapped
+// file and hold 32-bit values. Tables are move-only.
+class HeuristicTable
+{
+public:
+    HeuristicTable() = default;
+    explicit HeuristicTable(const vector<int>& distances); // INT_MAX for unreachable locations
+    HeuristicTable(const int* values, size_t num_of_values): values32(values), num_of_values(num_of_values) {}
+    HeuristicTable(HeuristicTable&&) = default;
+    HeuristicTable& operator=(HeuristicTable&&) = default;
+
+    size_t size() const { return num_of_values; }
+    bool is_owned() const { return !compact.empty() || !wide.empty(); }
+    size_t memory_usage() const { return compact.size() * sizeof(uint16_t) + wide.size() * sizeof(int); }
+    void copy_to(vector<int>& distances) const; // decode to INT_MAX for unreachable locations
+
+private:
+    vector<uint16_t> compact; // UINT16_MAX for unreachable locations
+    vector<int> wide; // INT_MAX for unreachable locations
+    const uint16_t* values16 = nullptr;
+    const int* values32 = nullptr;
+    size_t num_of_values = 0;
+
+    friend class HeuristicView;
+};
+
+
+// Read-only view of the heuristic values of one goal location.
+// It points into a table of BasicGraph::heuristics, so it is cheap to pass around, but it is only valid
+// until the next table is added to the store, which may evict the table it points to.
+// In the LANDMARK mode, it answers the queries from BasicGraph::landmarks instead.
+// Unreachable locations are returned as DBL_MAX.
+class HeuristicView
+{
+public:
+    HeuristicView() = default;
+    explicit HeuristicView(const HeuristicTable& table):
+        values16(table.values16), values32(table.values32), num_of_values(table.num_of_values) {}
+    HeuristicView(const LandmarkHeuristic& landmarks, int goal, size_t num_of_locations):
+        num_of_values(num_of_locations), landmarks(&landmarks), goal(goal) {}
+
+    double operator[](int location) const
+    {
+        if (values16 != nullptr)
+        {
+            uint16_t h = values16[location];
+            return h == UINT16_MAX ? DBL_MAX : h;
+        }
+        if (values32 != nullptr)
+        {
+            int h = values32[location];
+            return h == INT_MAX ? DBL_MAX : h;
+        }
+        return landmarks->get_h_value(location, goal);
+    }
+    size_t size() const { return num_of_values; }
+    bool empty() const { return values16 == nullptr && values32 == nullptr && landmarks == nullptr; }
+
+private:
+    const uint16_t* values16 = nullptr;
+    const int* values32 = nullptr;
+    size_t num_of_values = 0;
+    const LandmarkHeuristic* landmarks = nullptr;
+    int goal = -1;
+};
+
+
+// Heuristic tables by root location.
+// The tables computed by this process count against a memory budget. Once it is exceeded, the least recently
+// used computed tables are evicted, and BasicGraph::get_heuristic recomputes them when they are queried again.
+// Memory-mapped tables are backed by the page cache and are never evicted.
+class HeuristicStore
+{
+public:
+    size_t memory_budget = 0; // bytes for computed tables, 0 for unlimited
+
+    // statistics
+    uint64_t num_of_hits = 0;
+    uint64_t num_of_misses = 0;
+    uint64_t num_of_evictions = 0;
+    size_t peak_memory_usage = 0;
+
+    // return nullptr if there is no table for root_location; count the query as a hit or a miss
+    const HeuristicTable* find(int root_location);
+    // add (or replace) the table of root_location and evict tables if the budget is exceeded
+    const HeuristicTable& insert(int root_location, HeuristicTable&& table);
+    bool contains(int root_location) const { return tables.find(root_location) != tables.end(); }
+    const HeuristicTable& at(int root_location) const { return tables.at(root_location).table; }
+    vector<int> get_root_locations() const; // in increasing order
+
+    size_t size() const { return tables.size(); }
+    size_t memory_usage() const { return owned_memory; }
+
+private:
+    struct Entry
+    {
+        HeuristicTable table;
+        list<int>::iterator lru_position; // only for owned tables
+    };
+    unordered_map<int, Entry> tables;
+    list<int> lru; // root locations of the owned tables, the most recently used first
+    size_t owned_memory = 0;
+
+    void erase(unordered_map<int, Entry>::iterator it);
+};
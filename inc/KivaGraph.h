@@ -11,6 +11,9 @@ public:
 
     bool load_map(string fname);
     void preprocessing(bool consider_rotation); // compute heuristics
+    void save_locations(SnapshotWriter& writer) const;
+    bool load_locations(SnapshotReader& reader);
+    string get_grid_type() const { return "KivaGrid"; }
 private:
     bool load_weighted_map(string fname);
     bool load_unweighted_map(string fname);
@@ -0,0 +1,45 @@
+#pragma once
+#include "common.h"
+
+class BasicGraph;
+
+
+// Landmark-based (ALT) lower bounds on the distance between any two locations.
+// It stores the distances from every location to a few landmarks, chosen one by one as the location
+// farthest from the landmarks chosen so far. By the triangle inequality,
+// dist(loc, goal) >= dist(loc, landmark) - dist(goal, landmark) for every landmark, so the heuristic
+// is the max of these bounds (and of the Manhattan distance scaled by the cheapest move).
+// Its memory is O(landmarks x locations) instead of O(goals x locations).
+class LandmarkHeuristic
+{
+public:
+    void build(const BasicGraph& G, int num_of_landmarks);
+
+    bool empty() const { return landmarks.empty(); }
+    int size() const { return (int)landmarks.size(); }
+
+    double get_h_value(int location, int goal) const
+    {
+        const int* from = &distances[(size_t)location * landmarks.size()];
+        const int* to = &distances[(size_t)goal * landmarks.size()];
+        int h = manhattan_weight * (abs(location / cols - goal / cols) + abs(location % cols - goal % cols));
+        for (size_t i = 0; i < landmarks.size(); i++)
+        {
+            if (to[i] == INT_MAX) // the goal cannot reach this landmark
+                continue;
+            if (from[i] == INT_MAX) // the goal can reach the landmark but the location cannot, so it cannot reach the goal
+                return DBL_MAX;
+            h = max(h, from[i] - to[i] - slack);
+        }
+        return h;
+    }
+
+private:
+    vector<int> landmarks;
+    vector<int> distances; // distances[loc * number of landmarks + i] is the distance from loc to the i-th landmark
+    // subtracted from each bound to keep it admissible: the cost of turning around at the goal
+    // when rotation is considered, plus 1 if the distances are rounded down
+    int slack = 0;
+    int manhattan_weight = 0; // the cheapest move, rounded down
+    int cols = 1;
+};
@@ -56,6 +56,9 @@ public:
     // validate
     bool validate_solution();
     void print_solution() const;
+
+	void set_constraint_table_mode(constraint_table_mode mode) { rt.ct_mode = mode; initial_rt.ct_mode = mode; }
+	const ReservationTable& get_reservation_table() const { return rt; }
 protected:
     vector<vector<bool> > cat; // conflict avoidance table
     vector<unordered_set< pair<int, int> > > constraint_table;
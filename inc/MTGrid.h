@@ -10,4 +10,5 @@ public:
     bool load_map(string fname);
     void preprocessing(bool consider_rotation); // compute heuristics
     int random_location(std::mt19937& rng) const;
+    string get_grid_type() const { return "MTGrid"; }
 };
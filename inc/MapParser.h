@@ -0,0 +1,53 @@
+#pragma once
+#include "common.h"
+#include "MappedFile.h"
+#include <chrono>
+#include <cstring>
+
+
+// A piece of the map file. It points into the mapped file, so it is only valid while the parser is open.
+struct MapToken
+{
+    const char* begin = nullptr;
+    size_t length = 0;
+
+    bool operator==(const char* str) const { return strncmp(begin, str, length) == 0 && str[length] == '\0'; }
+    bool operator!=(const char* str) const { return !(*this == str); }
+    char operator[](size_t i) const { return begin[i]; }
+    string to_string() const { return string(begin, length); }
+};
+
+
+// Reads a map file in place through a memory mapping, so that the grid classes can fill their
+// arrays directly without allocating a string per line or per token.
+// Fields are separated by sep within a line (and by any whitespace when sep is ' ').
+// Reading past the end of a line or of the file returns empty tokens and zeros.
+class MapParser
+{
+public:
+    bool open(const string& fname); // return false if the file does not exist or is empty
+
+    bool eof() const { return pos >= end; }
+    bool eol() const { return pos >= end || *pos == '\n' || *pos == '\r'; }
+    size_t size() const { return file.size(); }
+    double get_runtime() const; // wall-clock seconds since the file was opened
+
+    MapToken read_line(); // the rest of the current line, without the line break
+    void skip_line() { read_line(); }
+    MapToken read_field(char sep);
+    void skip_fields(int num_of_fields, char sep);
+    int read_int(char sep) { return to_int(read_field(sep)); }
+    double read_double(char sep) { return to_double(read_field(sep)); }
+    MapToken read_word(); // the next whitespace-separated word, which may be on a later line
+    int read_int() { return to_int(read_word()); }
+    double read_double() { return to_double(read_word()); }
+
+    static int to_int(const MapToken& token);
+    static double to_double(const MapToken& token); // "inf" is returned as DBL_MAX
+
+private:
+    MappedFile file;
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "common.h"
+#include <cstdint>
+
+
+// Read-only memory mapping of a whole file.
+// The pages are loaded on first access and are shared by all processes that map the same file.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& fname); // return false if the file cannot be mapped
+    void close();
+
+    bool is_open() const { return bytes != nullptr; }
+    const char* data() const { return bytes; }
+    size_t size() const { return num_of_bytes; }
+    uint64_t get_content_hash() const; // FNV-1a hash of the file content
+
+private:
+    const char* bytes = nullptr;
+    size_t num_of_bytes = 0;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "common.h"
+#include <memory>
+#include <new>
+#include <type_traits>
+
+
+// Storage for the nodes of one search at a time.
+// Nodes are placed in fixed-size blocks that are kept across searches, so after the first few searches
+// creating a node does not allocate, and reset() releases all nodes in O(1).
+// Nodes never move, so pointers to them stay valid until the next reset.
+template <typename Node>
+class NodeArena
+{
+public:
+    static_assert(std::is_trivially_destructible<Node>::value, "reset() does not call destructors");
+
+    template <typename... Args>
+    Node* create(Args&&... args)
+    {
+        if (num_of_nodes == blocks.size() * block_size)
+        {
+            blocks.emplace_back(static_cast<Node*>(::operator new(block_size * sizeof(Node))));
+            num_of_allocations++;
+        }
+        Node* node = blocks[num_of_nodes / block_size].get() + num_of_nodes % block_size;
+        num_of_nodes++;
+        return new (node) Node(std::forward<Args>(args)...);
+    }
+    // release all nodes but keep the blocks; return the number of blocks allocated since the last reset
+    uint64_t reset()
+    {
+        num_of_nodes = 0;
+        uint64_t allocations = num_of_allocations;
+        num_of_allocations = 0;
+        return allocations;
+    }
+
+    Node* operator[](size_t index) const { return blocks[index / block_size].get() + index % block_size; }
+    size_t size() const { return num_of_nodes; }
+    size_t capacity() const { return blocks.size() * block_size; }
+
+private:
+    struct Deleter
+    {
+        void operator()(Node* block) const { ::operator delete(block); }
+    };
+    static const size_t block_size = 4096; // nodes per block
+    vector<std::unique_ptr<Node, Deleter> > blocks;
+    size_t num_of_nodes = 0;
+    uint64_t num_of_allocations = 0;
+};
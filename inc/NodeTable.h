@@ -0,0 +1,95 @@
+#pragma once
+#include "NodeArena.h"
+#include <cassert>
+
+
+// Duplicate detection for the nodes of one search: an open-addressing hash table of arena indices.
+// Node::get_key() packs the identity of a node (location, orientation, and timestep or interval) into 64 bits,
+// and every slot stores the index of its node and 16 bits of the hash of its key. So a probe reads one 8-byte slot
+// and dereferences a node only if the hash bits match, and then EqNode decides whether the nodes are equal.
+// The slots are kept across searches. Every slot also stores the generation of the table when it was filled,
+// and clear() starts a new generation, so the slots of earlier generations are empty without touching them.
+template <typename Node, typename EqNode>
+class NodeTable
+{
+public:
+    explicit NodeTable(const NodeArena<Node>& nodes): nodes(nodes) {}
+
+    // the node in the table that is equal to node, or nullptr
+    Node* find(const Node* node) const
+    {
+        if (num_of_nodes == 0)
+            return nullptr;
+        uint64_t hash = get_hash(node);
+        for (size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            const Slot& slot = slots[i];
+            if (slot.generation != generation)
+                return nullptr;
+            if (slot.fingerprint == (uint16_t)(hash >> 48) && EqNode()(nodes[slot.index], node))
+                return nodes[slot.index];
+        }
+    }
+    // insert the node that was created last in the arena, which must not be equal to any node in the table
+    void insert(const Node* node)
+    {
+        assert(nodes.size() > 0 && nodes[nodes.size() - 1] == node);
+        if (2 * (num_of_nodes + 1) > slots.size())
+            grow();
+        put(get_hash(node), (uint32_t)(nodes.size() - 1));
+        num_of_nodes++;
+    }
+    void clear()
+    {
+        num_of_nodes = 0;
+        if (++generation == 0) // the generations wrapped around, so the old ones are reused
+        {
+            for (Slot& slot : slots)
+                slot.generation = 0;
+            generation = 1;
+        }
+    }
+    size_t size() const { return num_of_nodes; }
+
+private:
+    struct Slot
+    {
+        uint32_t index = 0;
+        uint16_t fingerprint = 0;
+        uint16_t generation = 0; // the slot is used if it equals the generation of the table
+    };
+
+    const NodeArena<Node>& nodes;
+    vector<Slot> slots; // the size is a power of two, and at most half of the slots are used
+    size_t mask = 0;
+    size_t num_of_nodes = 0;
+    uint16_t generation = 1;
+
+    static uint64_t get_hash(const Node* node) // the finalizer of splitmix64, so that all bits depend on the key
+    {
+        uint64_t x = node->get_key();
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+    void put(uint64_t hash, uint32_t index)
+    {
+        size_t i = hash & mask;
+        while (slots[i].generation == generation)
+            i = (i + 1) & mask;
+        slots[i].index = index;
+        slots[i].fingerprint = (uint16_t)(hash >> 48);
+        slots[i].generation = generation;
+    }
+    void grow() // double the slots (or allocate the first ones) and rehash the used ones
+    {
+        vector<Slot> old_slots(max(slots.size() * 2, (size_t)1024));
+        old_slots.swap(slots);
+        mask = slots.size() - 1;
+        for (const Slot& slot : old_slots)
+        {
+            if (slot.generation == generation)
+                put(get_hash(nodes[slot.index]), slot.index);
+        }
+    }
+};
@@ -10,4 +10,7 @@ public:
 	vector<int> exits;
     bool load_map(string fname);
     void preprocessing(bool consider_rotation); // compute heuristics
+    void save_locations(SnapshotWriter& writer) const;
+    bool load_locations(SnapshotReader& reader);
+    string get_grid_type() const { return "OnlineGrid"; }
 };
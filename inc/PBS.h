@@ -1,6 +1,7 @@
 #pragma once
 #include "PBSNode.h"
 #include "MAPFSolver.h"
+#include "PrioritizedPlanner.h"
 #include <ctime>
 
 // TODO: add topological sorting
@@ -11,6 +12,7 @@ class PBS:
 public:
     bool lazyPriority;
     bool prioritize_start = true;
+    bool prioritized_root = false; // plan the root paths by prioritized planning instead of independently
 
 	 // runtime breakdown
     double runtime_rt = 0;
@@ -65,6 +67,11 @@ private:
 
     std::vector< Path* > paths;
     list<PBSNode*> allNodes_table;
+
+    // the reservations that rt currently holds for every agent, so that rt can be updated by delta
+    vector<const Path*> rt_paths;
+    vector<const Path*> rt_start_paths;
+    vector<bool> rt_initial_constraints;
     list<PBSNode*> dfs;
 
    //  vector<State> starts;
@@ -107,6 +114,8 @@ private:
     void get_solution();
 
     void update_CAT(int ex_ag); // update conflict avoidance table
+    void update_rt(const unordered_set<int>& high_priority_agents, int agent); // prepare rt for planning agent
+    void forget_rt_path(int agent, const Path* path); // called before the path is deleted
 	void update_focal_list();
 	inline void release_closed_list();
     void update_best_node(PBSNode* node);
@@ -0,0 +1,42 @@
+#pragma once
+#include "SingleAgentSolver.h"
+#include "ThreadPool.h"
+#include <memory>
+
+// Runs independent single-agent searches concurrently, one planner instance per thread.
+// The calling thread searches with the given planner and the other threads with clones of it.
+// A reservation table can be shared by several queries only if it is finalized.
+// Otherwise each query needs its own table, which can share a finalized base layer with the others.
+class PlannerPool
+{
+public:
+    struct Query
+    {
+        State start;
+        const vector<pair<int, int> >* goal_locations;
+        ReservationTable* rt;
+        // results
+        Path path;
+        double path_cost = 0;
+        double min_f_val = 0;
+        uint64_t num_expanded = 0;
+        uint64_t num_generated = 0;
+
+        Query(const State& start, const vector<pair<int, int> >& goal_locations, ReservationTable& rt):
+            start(start), goal_locations(&goal_locations), rt(&rt) {}
+    };
+
+    PlannerPool(BasicGraph& G, SingleAgentSolver& path_planner, int num_threads);
+    ~PlannerPool();
+
+    int size() const { return (int)planners.size(); }
+    void run(vector<Query>& queries); // the statistics of all searches are added to path_planner
+
+private:
+    BasicGraph& G;
+    SingleAgentSolver& path_planner;
+    vector<SingleAgentSolver*> planners; // planners[0] is path_planner
+    std::unique_ptr<ThreadPool> threads;
+
+    void run(Query& query, SingleAgentSolver& planner);
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "SingleAgentSolver.h"
+
+// Sequential prioritized planning on one growing reservation table.
+// Every agent is planned against the reservations of all other agents, i.e., the new paths of the agents planned
+// before it in the sweep and the initial paths of the others, and its new path then replaces its initial path
+// in O(path length). A new sweep rolls the table back to the initial reservations instead of rebuilding it.
+// Used by WHCA*, by the PBS root node and as the fallback of BasicSystem::solve.
+class PrioritizedPlanner
+{
+public:
+    uint64_t num_expanded = 0;
+    uint64_t num_generated = 0;
+    uint64_t num_of_plans = 0;
+    bool reserve_starts = false; // other agents cannot use the start location of a path before it leaves
+
+    PrioritizedPlanner(BasicGraph& G, SingleAgentSolver& path_planner, ReservationTable& rt):
+        G(G), path_planner(path_planner), rt(rt) {}
+
+    // Reserve the initial paths (empty ones are skipped) and the initial constraints of all agents on top of base.
+    // rt must be configured (sizes, window and k_robust) before.
+    void init(const ReservationTable& base, const vector<Path>& initial_paths,
+              const list< tuple<int, int, int> >& initial_constraints);
+    void restart(); // undo all paths planned since init
+    // Plan the agent and reserve its new path. Return an empty path if there is none.
+    Path plan(int agent, const State& start, const vector<pair<int, int> >& goal_locations);
+    void clear() { rt.clear(); } // release the reservations
+
+private:
+    BasicGraph& G;
+    SingleAgentSolver& path_planner;
+    ReservationTable& rt;
+    const list< tuple<int, int, int> >* initial_constraints = nullptr;
+    int initial_version = 0;
+};
@@ -1,6 +1,12 @@
 #pragma once
 #include "States.h"
 #include "BasicGraph.h"
+#include "ConstraintTable.h"
+#include "ConflictAvoidanceTable.h"
+#include <cassert>
+
+// the kinds of reservations that an agent can own in the reservation table
+enum reservation_kind { PATH_RESERVATION, START_RESERVATION, INITIAL_RESERVATION, RESERVATION_KIND_COUNT };
 
 class ReservationTable
 {
@@ -11,59 +17,213 @@ public:
     int window;
     bool use_cat; // use conflict avoidance table
 	bool hold_endpoints = false;
+	constraint_table_mode ct_mode = HASHED_TABLE; // how the hard constraints are stored
 
     bool prioritize_start;
     double runtime;
 
-    void clear() {sit.clear(); ct.clear(); cat.clear(); }
-	void copy(const ReservationTable& other) {sit = other.sit; ct = other.ct; cat = other.cat; }
-    void build(const vector<Path*>& paths,
-               const list< tuple<int, int, int> >& initial_constraints,
-               const unordered_set<int>& high_priority_agents, int current_agent, int start_location);
-    void build(const vector<Path>& paths,
-               const list< tuple<int, int, int> >& initial_constraints,
-               int current_agent);
+	// accumulated over all builds and copies, used to report the cost of preparing the table
+	uint64_t num_of_builds = 0;
+	double accumulated_runtime = 0;
+
+    void clear();
+	void copy(const ReservationTable& other);
+	// Use other as a shared base layer: its constraints apply in addition to the ones of this table
+	// without being copied. other must not change until this table is cleared.
+	// Only a finalized table can be a base with soft constraints or with a base of its own.
+	void setBase(const ReservationTable& other);
+	// Compute the safe intervals of all vertices and edges with constraints, so that the queries no longer
+	// modify the table. It can then be shared by concurrent searches, directly or as their base layer.
+	// Any update undoes it.
+	void finalize();
+	bool isFinalized() const { return finalized; }
     void build(const vector<Path*>& paths,
                const list< tuple<int, int, int> >& initial_constraints,
                const list< Constraint >& constraints, int current_agent);
 	void insertPath2CT(const Path& path); // insert the path to the constraint table
+
+	// Incremental updates, used instead of rebuilding the table before every low-level search.
+	// Every reservation is owned by an agent and a kind, so that it can be removed again.
+	// Safe intervals that were already computed are updated along with the constraints.
+	void insertPath(int agent, const Path& path); // replaces the previous path of the agent
+	// other agents cannot use the start location of the path before the agent leaves it
+	void insertStartConstraint(int agent, const Path& path);
+	// the initial constraints of the agent, i.e., other agents cannot use its location before the given timestep
+	void insertInitialConstraints(int agent, const list< tuple<int, int, int> >& initial_constraints);
+	void remove(int agent, reservation_kind kind);
+	bool contains(int agent, reservation_kind kind) const
+	{
+		int owner = getOwner(agent, kind);
+		return owner < (int)owned.size() && owned[owner];
+	}
+	// Start recording the incremental updates and return the version of the current state.
+	// rollback(version) undoes all updates made after it.
+	int checkpoint();
+	void rollback(int version);
+	void recordBuild(clock_t start) // set runtime to the time since start and add it to the accumulated statistics
+	{
+		runtime = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+		num_of_builds++;
+		accumulated_runtime += runtime;
+	}
+	void copySettings(const ReservationTable& other); // the sizes, window, k_robust and the flags, not the constraints
+	void mergeStatistics(ReservationTable& other) // move the accumulated statistics of other to this table
+	{
+		num_of_builds += other.num_of_builds;
+		accumulated_runtime += other.accumulated_runtime;
+		other.num_of_builds = 0;
+		other.accumulated_runtime = 0;
+	}
+
 	void print() const;
     void printCT(size_t location) const;
 
     // functions  for SIPP
-    list<Interval> getSafeIntervals(int location, int lower_bound, int upper_bound);
-	list<Interval> getSafeIntervals(int from, int to, int lower_bound, int upper_bound);
+	// Call visit(interval) for every safe interval of the location that overlaps [lower_bound, upper_bound),
+	// in increasing order of time. The intervals are read in place, so nothing is allocated.
+	template <typename Visitor>
+	void forEachSafeInterval(int location, int lower_bound, int upper_bound, Visitor visit)
+	{
+		if (lower_bound >= upper_bound)
+			return;
+		const Interval* end;
+		for (const Interval* it = findSafeIntervals(location, lower_bound, end);
+			it != end && std::get<0>(*it) < upper_bound; ++it)
+			visit(*it);
+	}
+	// The same for moving from `from` to `to`: visit the intersections of the safe intervals of `to`
+	// and of the edge, whose number of conflicts is the sum of both.
+	// Edges without constraints, which are the vast majority, cost a single lookup.
+	template <typename Visitor>
+	void forEachSafeInterval(int from, int to, int lower_bound, int upper_bound, Visitor visit)
+	{
+		if (from == to)
+		{
+			forEachSafeInterval(to, lower_bound, upper_bound, visit);
+			return;
+		}
+		size_t edge = getEdgeIndex(from, to);
+		if (!hasEdgeConstraints(edge))
+		{
+			forEachSafeInterval(to, lower_bound, upper_bound, visit);
+			return;
+		}
+		if (lower_bound >= upper_bound)
+			return;
+		const Interval *end1, *end2;
+		const Interval* it1 = findSafeIntervals(to, lower_bound, end1);
+		const Interval* it2 = findSafeIntervals(edge, lower_bound, end2);
+		while (it1 != end1 && it2 != end2 && std::get<0>(*it1) < upper_bound && std::get<0>(*it2) < upper_bound)
+		{
+			int t_min = max(std::get<0>(*it1), std::get<0>(*it2));
+			int t_max = min(std::get<1>(*it1), std::get<1>(*it2));
+			if (t_min < t_max)
+				visit(Interval(t_min, t_max, std::get<2>(*it1) + std::get<2>(*it2)));
+			if (t_max == std::get<1>(*it1))
+				++it1;
+			if (t_max == std::get<1>(*it2))
+				++it2;
+		}
+	}
+	// Call visit(location, t) for the hard constraints on every location and on the moves into it,
+	// where t is the end of the last one. So neither is constrained from the maximum t on.
+	// The locations without hard constraints are not visited, the others maybe repeatedly.
+	template <typename Visitor>
+	void forEachFreeTime(Visitor visit) const
+	{
+		auto visit_ranges = [&](size_t id, const TimeRanges& ranges)
+		{
+			int t = 0;
+			for (const auto& range : ranges)
+				t = max(t, range.t_max);
+			if (t > 0)
+				visit(id < map_size ? (int)id : getEdge(id).second, t);
+		};
+		ct.for_each(visit_ranges);
+		if (base != nullptr)
+			base->forEachFreeTime(visit);
+	}
 	int getHoldingTimeFromSIT(int location);
     Interval getFirstSafeInterval(int location);
     bool findSafeInterval(Interval& interval, int location, int t_min);
 
 	// functions for state-time A*
 	bool isConstrained(int curr_id, int next_id, int next_timestep) const;
-	bool isConflicting(int curr_id, int next_id, int next_timestep) const;
+	int getNumOfConflicts(int curr_id, int next_id, int next_timestep) const; // with the paths in the CAT
 	int getHoldingTimeFromCT(int location) const;
     set<int> getConstrainedTimesteps(int location) const;
 
 	ReservationTable(BasicGraph& G): G(G) {}
 private:
 	BasicGraph& G;
+	const ReservationTable* base = nullptr; // the base layer, nullptr if there is none or it is empty
+	bool finalized = false; // all safe intervals are computed
 	// Constraint Table (CT)
-	unordered_map<size_t, list<pair<int, int> > > ct; // location/edge -> time range
+	ConstraintTable ct; // location/edge -> time ranges
 	// Conflict Avoidance Table (CAT)
-	vector<vector<bool> > cat; //  (timestep, location) ->  have conflicts or not
+	ConflictAvoidanceTable cat; // (location, timestep) -> number of agents
 	// Safe Interval Table (SIT)
-	unordered_map<size_t, list<Interval > > sit; // location/edge -> [t_min, t_max), num_of_collisions
+	// location/edge -> sorted, disjoint [t_min, t_max), number of conflicts
+	unordered_map<size_t, vector<Interval> > sit;
+	static const Interval full_interval; // the safe interval of the locations without constraints
 
-	void updateSIT(size_t location); // update SIT at the gvien location
-	void mergeIntervals(list<Interval >& intervals) const; //merge successive safe intervals with the same number of conflicts.
+	// owners of the reservations
+	int current_owner = -1; // the owner of the constraints that are inserted now (-1 for none)
+	vector<bool> owned; // owner -> the reservation exists
+	vector<vector<size_t> > owned_ids; // owner -> the vertices/edges where it inserted constraints
+	struct Change // an incremental update, recorded after checkpoint() so that it can be undone
+	{
+		int owner;
+		bool inserted;
+		vector<pair<size_t, TimeRange> > removed_ranges; // only for removals
+	};
+	bool recording = false;
+	vector<Change> changes;
 
+	static int getOwner(int agent, reservation_kind kind) { return agent * RESERVATION_KIND_COUNT + kind; }
+	void beginReservation(int agent, reservation_kind kind); // the following constraints are owned by it
+	void removeOwner(int owner);
+	void reserve(size_t id, int t_min, int t_max); // insert a hard constraint owned by current_owner
+	void reserveSwap(int from, int to, int timestep); // other agents cannot move from `from` to `to` at timestep
 
+	void configureCT(); // adapt ct to ct_mode, map_size and the planning window
+	void updateSIT(size_t location); // update SIT at the gvien location
+	// the safe intervals of the location/edge in this table or in its finalized base, nullptr if it has none
+	const vector<Interval>* lookupSIT(size_t id) const;
+	// the number of agents at the location at the timestep in the CATs of this table and its base layers
+	int getCATCount(int location, int timestep) const
+	{
+		return cat.get(location, timestep) + (base == nullptr ? 0 : base->getCATCount(location, timestep));
+	}
+	// the number of agents that can move along the edge at the timestep, i.e., in its opposite direction
+	int getEdgeCATCount(pair<int, int> edge, int timestep) const
+	{
+		return min(getCATCount(edge.first, timestep), getCATCount(edge.second, timestep - 1));
+	}
+	// the safe intervals of the location/edge from the first one that ends after lower_bound to end
+	const Interval* findSafeIntervals(size_t id, int lower_bound, const Interval*& end);
 
-    void insertConstraint2SIT(int location, int t_min, int t_max);
-    void insertSoftConstraint2SIT(int location, int t_min, int t_max);
-    void insertConstraints4starts(const vector<Path*>& paths, int current_agent, int start_location);	
+    void insertConstraint2SIT(size_t location, int t_min, int t_max);
+    void insertSoftConstraint2SIT(size_t location, int t_min, int t_max, int num_of_conflicts);
 	void insertPath2CAT(const Path& path); //  insert the path to the conflict avoidance table
 	void addInitialConstraints(const list< tuple<int, int, int> >& initial_constraints, int current_agent);
-	inline int getEdgeIndex(int from, int to) const {return (from + 1) * map_size + to; }
-	inline pair<int, int> getEdge(int index) const {return make_pair(index / map_size - 1, index % map_size); }
+	// Vertices have ids in [0, map_size). Edges between neighboring locations are numbered after them
+	// by their start location and direction, so all ids are in [0, 5 * map_size).
+	size_t getNumOfIds() const { return map_size * 5; }
+	inline size_t getEdgeIndex(int from, int to) const
+	{
+		int direction = G.get_direction(from, to);
+		assert(0 <= direction && direction < 4);
+		return map_size + (size_t)from * 4 + direction;
+	}
+	inline pair<int, int> getEdge(size_t index) const
+	{
+		int from = (int)((index - map_size) / 4);
+		return make_pair(from, from + G.move[(index - map_size) % 4]);
+	}
+	bool hasEdgeConstraints(size_t edge) const // including the soft ones
+	{
+		return ct.find(edge) != nullptr || !cat.empty() || (base != nullptr && base->hasEdgeConstraints(edge));
+	}
 
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "StateTimeAStar.h"
 #include "SingleAgentSolver.h"
+#include <memory>
 // TODO: make SIPP work with edge-weighted graphs
 
 
@@ -43,6 +44,12 @@ public:
     handle_type open_handle;
     fibonacci_heap< SIPPNode*, compare<SIPPNode::secondary_compare_node> >::
     handle_type focal_handle;
+    // positions in the OPEN and FOCAL lists of the other queue policies (see SearchQueues.h)
+    int open_bucket = -1;
+    int open_position = -1;
+    int focal_position = -1;
+    // jump point search: bit dir is set if a move in direction dir reaches the node at its cost without waiting
+    int jump_dirs = 0;
 
 
     SIPPNode(): StateTimeAStarNode(), parent(nullptr) {}
@@ -78,6 +85,13 @@ public:
                   n1->goal_id == n2->goal_id);
         }
     };
+
+    // the location, orientation and start of the interval packed into 64 bits (see StateTimeAStarNode::get_key)
+    uint64_t get_key() const
+    {
+        return ((uint64_t)(uint32_t)state.location << 32) ^ ((uint64_t)(uint32_t)std::get<0>(interval) << 3) ^
+               (uint64_t)(state.orientation + 1);
+    }
 };
 
 
@@ -88,19 +102,70 @@ public:
              const vector<pair<int, int> >& goal_location,
              ReservationTable& RT);
 	string getName() const { return "SIPP"; }
+	SingleAgentSolver* clone() const
+	{
+		SIPP* planner = new SIPP();
+		planner->copy_settings(*this);
+		planner->windowed = windowed;
+		planner->jump_points = jump_points;
+		planner->validate_jump_points = validate_jump_points;
+		return planner;
+	}
     SIPP(): SingleAgentSolver() {}
 
+	// Search in time-space only up to the planning window plus k_robust, where the reservations end,
+	// and complete the path by following the heuristic to the remaining goals.
+	// Only used with exact heuristics (SHORTEST_PATH on grids with integer weights, as the distances are rounded
+	// down otherwise), without rotation and without travel times.
+	bool windowed = false;
+
+	// Generate jump points instead of all neighbors where no reservations are nearby (jump point search on
+	// 4-neighbor grids, with horizontal moves turning only at forced neighbors), and stop every jump next to
+	// the reserved locations and at the goal. The path costs are the same as without it.
+	// Only used on grids with uniform weights, without rotation, travel times and conflict avoidance tables.
+	bool jump_points = false;
+	// Debug mode: repeat every search with jump points without them, and exit if the path costs differ.
+	bool validate_jump_points = false;
+
 private:
-    // define typedefs and handles for heap and hash_map
-    fibonacci_heap< SIPPNode*, compare<SIPPNode::compare_node> > open_list;
-    fibonacci_heap< SIPPNode*, compare<SIPPNode::secondary_compare_node> > focal_list;
-    unordered_set< SIPPNode*, SIPPNode::Hasher, SIPPNode::EqNode> allNodes_table;
+    SearchContext<SIPPNode> context; // the nodes and the OPEN and FOCAL lists, kept across searches
 	inline void releaseClosedListNodes();
 
+    template <typename Open, typename Focal>
+    Path search(BasicGraph& G, const State& start, const vector<pair<int, int> >& goal_location,
+                ReservationTable& rt, Open& open_list, Focal& focal_list);
+    // from is the location where the last move starts if it is not the location of curr (for jump points)
+    template <typename Open, typename Focal>
     void generate_node(const Interval& interval, SIPPNode* curr, BasicGraph& G,
-                       int location, int min_timestep, int orientation, double h_val);
+                       int location, int min_timestep, int orientation, double h_val,
+                       Open& open_list, Focal& focal_list, int from = -1);
+
+    // jump point search
+    bool jumping = false; // the current search generates jump points
+    std::unique_ptr<SIPP> plain_sipp; // the planner without jump points for validate_jump_points
+    void validateJumpPoints(BasicGraph& G, const State& start, const vector<pair<int, int> >& goal_location,
+                            ReservationTable& rt, const Path& path);
+    // location -> the earliest timestep from which neither the location nor the moves into it are reserved
+    vector<int> free_times;
+    vector<int> clear_times; // location -> the earliest timestep from which isFree holds
+    vector<int> reserved_locations; // the locations where free_times or clear_times are not 0
+    void updateFreeTimes(BasicGraph& G, const ReservationTable& rt); // for the current search
+    // Generate the jump points from curr. Return false if curr has to be expanded normally,
+    // i.e., it is the start or at a goal or next to reserved locations.
+    template <typename Open, typename Focal>
+    bool generateJumpPoints(BasicGraph& G, SIPPNode* curr, const vector<pair<int, int> >& goal_location,
+                            ReservationTable& rt, Open& open_list, Focal& focal_list);
+    // the number of moves from location in direction dir to the next jump point, or 0 if there is none
+    int jump(BasicGraph& G, int location, int dir, int timestep, int goal) const;
+    // neither the location from timestep on nor its neighbors from timestep + 1 on are reserved
+    bool isFree(int location, int timestep) const { return clear_times[location] <= timestep; }
     // Updates the path
     Path updatePath(BasicGraph& G, const SIPPNode* goal);
+    // Move from the node along the heuristic through its remaining goals, one move per timestep and without waiting.
+    // Return false if a move is reserved, a goal is reached before its release time or the last goal before it can
+    // be held. Otherwise, tail is a shortest continuation of the node.
+    bool followHeuristic(BasicGraph& G, const SIPPNode* node, const vector<pair<int, int> >& goal_location,
+                         const ReservationTable& rt, int earliest_holding_time, Path& tail) const;
 
 };
 
@@ -0,0 +1,36 @@
+#pragma once
+#include "NodeTable.h"
+#include "SearchQueues.h"
+
+
+// The storage that a planner reuses across its searches: the nodes, the table of generated nodes,
+// and the OPEN and FOCAL lists of every queue policy (see SearchQueues.h).
+// Node provides compare_node, secondary_compare_node and EqNode, and the handles and positions of the queues.
+// Every part keeps its capacity when the context is reset, so a short search does not allocate
+// once the planner has run a few searches, and resetting costs O(1) per part
+// (the Fibonacci heaps are the exception, since they allocate and free one heap node per search node).
+template <typename Node>
+class SearchContext
+{
+public:
+    NodeArena<Node> nodes; // all nodes of the current search
+    NodeTable<Node, typename Node::EqNode> allNodes_table{nodes};
+
+    FibonacciQueue<Node, typename Node::compare_node, &Node::open_handle> fibonacci_open;
+    FibonacciQueue<Node, typename Node::secondary_compare_node, &Node::focal_handle> fibonacci_focal;
+    BucketQueue<Node, &Node::open_bucket, &Node::open_position> bucket_open;
+    DaryHeap<Node, typename Node::compare_node, &Node::open_position> heap_open;
+    DaryHeap<Node, typename Node::secondary_compare_node, &Node::focal_position> heap_focal;
+
+    // release all nodes and empty all lists; return the number of node blocks allocated since the last reset
+    uint64_t reset()
+    {
+        fibonacci_open.clear();
+        fibonacci_focal.clear();
+        bucket_open.clear();
+        heap_open.clear();
+        heap_focal.clear();
+        allNodes_table.clear();
+        return nodes.reset();
+    }
+};
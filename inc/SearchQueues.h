@@ -0,0 +1,218 @@
+#pragma once
+#include "common.h"
+#include <cassert>
+#include <cmath>
+
+// How the low-level planners store their OPEN and FOCAL lists.
+// BUCKET keeps OPEN in one bucket per f-value, which requires integer edge weights (and no travel times),
+// so the planners fall back to HEAP otherwise. FOCAL is a 4-ary heap in both BUCKET and HEAP.
+enum queue_policy { FIBONACCI_QUEUE, BUCKET_QUEUE, DARY_HEAP_QUEUE };
+
+// The queues below share one interface, so that a search can be instantiated with any of them:
+// push, top, pop, erase (any node), increase (its priority improved), update (its priority changed),
+// and for_each_in_range(lower, upper, visit), which visits the nodes with lower < f-value <= upper.
+// Compare follows boost::heap, i.e., compare(n1, n2) is true if n1 has a lower priority than n2.
+
+
+// boost::heap::fibonacci_heap with the handles stored in the nodes
+template <typename Node, typename Compare,
+          typename fibonacci_heap<Node*, compare<Compare> >::handle_type Node::*handle>
+class FibonacciQueue
+{
+public:
+    void push(Node* node) { node->*handle = heap.push(node); }
+    Node* top() const { return heap.top(); }
+    void pop() { heap.pop(); }
+    void erase(Node* node) { heap.erase(node->*handle); }
+    void increase(Node* node) { heap.increase(node->*handle); }
+    void update(Node* node) { heap.update(node->*handle); }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void clear() { heap.clear(); }
+
+    template <typename Visitor>
+    void for_each_in_range(double lower, double upper, Visitor visit) const
+    {
+        for (Node* node : heap)
+        {
+            if (node->getFVal() > lower && node->getFVal() <= upper)
+                visit(node);
+        }
+    }
+
+private:
+    fibonacci_heap<Node*, compare<Compare> > heap;
+};
+
+
+// Indexed 4-ary heap in a vector. Every node stores its position, so erase and update are O(log n)
+// without per-node allocations, and the wide nodes keep the heap shallow and its children in one cache line.
+template <typename Node, typename Compare, int Node::*position>
+class DaryHeap
+{
+public:
+    void push(Node* node)
+    {
+        heap.push_back(node);
+        sift_up((int)heap.size() - 1);
+    }
+    Node* top() const { return heap.front(); }
+    void pop() { erase(heap.front()); }
+    void erase(Node* node)
+    {
+        int i = node->*position;
+        Node* last = heap.back();
+        heap.pop_back();
+        if (last == node)
+            return;
+        place(last, i);
+        update(last);
+    }
+    void increase(Node* node) { sift_up(node->*position); }
+    void update(Node* node)
+    {
+        int i = node->*position;
+        sift_up(i);
+        if (heap[i] == node)
+            sift_down(i);
+    }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    void clear() { heap.clear(); }
+
+    template <typename Visitor>
+    void for_each_in_range(double lower, double upper, Visitor visit) const
+    {
+        for (Node* node : heap)
+        {
+            if (node->getFVal() > lower && node->getFVal() <= upper)
+                visit(node);
+        }
+    }
+
+private:
+    static const int arity = 4;
+    vector<Node*> heap;
+    Compare compare_nodes;
+
+    // ties keep their order, so that equal nodes are not swapped back and forth
+    bool lower_priority(const Node* n1, const Node* n2) const
+    {
+        return compare_nodes(n1, n2) && !compare_nodes(n2, n1);
+    }
+    void place(Node* node, int i)
+    {
+        heap[i] = node;
+        node->*position = i;
+    }
+    void sift_up(int i)
+    {
+        Node* node = heap[i];
+        while (i > 0)
+        {
+            int parent = (i - 1) / arity;
+            if (!lower_priority(heap[parent], node))
+                break;
+            place(heap[parent], i);
+            i = parent;
+        }
+        place(node, i);
+    }
+    void sift_down(int i)
+    {
+        Node* node = heap[i];
+        int n = (int)heap.size();
+        while (true)
+        {
+            int first = i * arity + 1;
+            if (first >= n)
+                break;
+            int best = first;
+            for (int child = first + 1; child < first + arity && child < n; child++)
+            {
+                if (lower_priority(heap[best], heap[child]))
+                    best = child;
+            }
+            if (!lower_priority(node, heap[best]))
+                break;
+            place(heap[best], i);
+            i = best;
+        }
+        place(node, i);
+    }
+};
+
+
+// Bucket queue for OPEN lists with integer f-values: one unordered bucket per f-value.
+// Only the f-value of the top node is meaningful, since the planners expand nodes from FOCAL.
+// Every node stores its bucket and its position in it, so all operations are O(1) except top,
+// which skips the buckets that were emptied since the last call.
+template <typename Node, int Node::*bucket, int Node::*position>
+class BucketQueue
+{
+public:
+    void push(Node* node)
+    {
+        assert(node->getFVal() == std::floor(node->getFVal()));
+        int key = (int)node->getFVal();
+        if (key >= (int)buckets.size())
+            buckets.resize(key + 1);
+        node->*bucket = key;
+        node->*position = (int)buckets[key].size();
+        buckets[key].push_back(node);
+        if (num_of_nodes == 0 || key < min_key)
+            min_key = key;
+        max_key = max(max_key, key);
+        num_of_nodes++;
+    }
+    Node* top()
+    {
+        while (buckets[min_key].empty())
+            min_key++;
+        return buckets[min_key].back();
+    }
+    void pop() { erase(top()); }
+    void erase(Node* node)
+    {
+        vector<Node*>& nodes = buckets[node->*bucket];
+        Node* last = nodes.back();
+        last->*position = node->*position;
+        nodes[node->*position] = last;
+        nodes.pop_back();
+        num_of_nodes--;
+    }
+    void increase(Node* node) { update(node); }
+    void update(Node* node)
+    {
+        erase(node);
+        push(node);
+    }
+    bool empty() const { return num_of_nodes == 0; }
+    size_t size() const { return num_of_nodes; }
+    void clear() // keep the buckets
+    {
+        for (int key = 0; key <= max_key && key < (int)buckets.size(); key++)
+            buckets[key].clear();
+        num_of_nodes = 0;
+        min_key = 0;
+        max_key = 0;
+    }
+
+    template <typename Visitor>
+    void for_each_in_range(double lower, double upper, Visitor visit) const
+    {
+        int first = (int)max(std::floor(lower) + 1, (double)min_key);
+        int last = (int)min(std::floor(upper), (double)max_key);
+        for (int key = first; key <= last; key++)
+        {
+            for (Node* node : buckets[key])
+                visit(node);
+        }
+    }
+
+private:
+    vector<vector<Node*> > buckets; // f-value -> nodes
+    size_t num_of_nodes = 0;
+    int min_key = 0; // no bucket below it has nodes
+    int max_key = 0; // no bucket above it has nodes
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "BasicGraph.h"
 #include "ReservationTable.h"
+#include "SearchQueues.h"
+#include <chrono>
 
 
 class SingleAgentSolver
@@ -10,27 +12,99 @@ public:
 	bool prioritize_start;
 	double suboptimal_bound;
 	bool hold_endpoints;
+	queue_policy queue = FIBONACCI_QUEUE;
 
 
     uint64_t num_expanded;
     uint64_t num_generated;
+	uint64_t num_of_allocations = 0; // heap allocations for the nodes of the last search
 	double runtime;
 
+	// accumulated over all calls of run(), used to report the low-level throughput
+	uint64_t num_of_searches = 0;
+	uint64_t accumulated_expanded = 0;
+	uint64_t accumulated_generated = 0;
+	uint64_t accumulated_allocations = 0;
+	double accumulated_runtime = 0;
+
     // int map_size;
     double path_cost;
     double min_f_val;  // min f-val seen so far
     int num_of_conf; // number of conflicts between this agent to all the other agents
 
-	unordered_map<int, double> travel_times;
+	// the travel times of the MAPF solver (not copied, so the solver must outlive its searches), or nullptr
+	const unordered_map<int, double>* travel_times = nullptr;
+	bool has_travel_times() const { return travel_times != nullptr && !travel_times->empty(); }
 
 	double compute_h_value(BasicGraph& G, int curr, int goal_id,
 		const vector<pair<int, int> >& goal_location) const;
+	// Fetch the heuristics of the goals before a search, so that the search does not query BasicGraph,
+	// and sum up the distances between consecutive goals from the back.
+	// BasicGraph::get_heuristic may compute tables, so the calls are serialized for concurrent searches.
+	// No table is cached if the heuristics have a memory budget, since a fetched table may evict another one.
+	void prepare_heuristics(BasicGraph& G, const vector<pair<int, int> >& goal_location);
+	// compute_h_value with the prepared heuristics: one lookup plus the distance through the remaining goals
+	double get_h_value(BasicGraph& G, int curr, int goal_id, const vector<pair<int, int> >& goal_location) const
+	{
+		assert(goal_suffix_h.size() == goal_location.size());
+		return get_goal_distance(G, curr, goal_id, goal_location) + goal_suffix_h[goal_id];
+	}
+	// the heuristic distance from curr to the goal with goal_id only, with the prepared heuristics
+	double get_goal_distance(BasicGraph& G, int curr, int goal_id, const vector<pair<int, int> >& goal_location) const
+	{
+		if (goal_heuristics.empty())
+			return G.get_heuristic(goal_location[goal_id].first)[curr];
+		return goal_heuristics[goal_id][curr];
+	}
 
     virtual Path run(BasicGraph& G, const State& start, const vector<pair<int, int> >& goal_location, ReservationTable& RT) = 0;
 	virtual string getName() const = 0;
+	// the queue used by the searches on G: BUCKET needs integer f-values, so it falls back to HEAP otherwise
+	queue_policy get_queue_policy(const BasicGraph& G) const
+	{
+		if (queue == BUCKET_QUEUE && (!G.has_integer_weights() || has_travel_times()))
+			return DARY_HEAP_QUEUE;
+		return queue;
+	}
+	// a new planner with the same settings, e.g., for running searches in another thread
+	virtual SingleAgentSolver* clone() const = 0;
+	void copy_settings(const SingleAgentSolver& other)
+	{
+		prioritize_start = other.prioritize_start;
+		suboptimal_bound = other.suboptimal_bound;
+		hold_endpoints = other.hold_endpoints;
+		queue = other.queue;
+		travel_times = other.travel_times;
+	}
+	void merge_statistics(SingleAgentSolver& other) // move the accumulated statistics of other to this planner
+	{
+		num_of_searches += other.num_of_searches;
+		accumulated_expanded += other.accumulated_expanded;
+		accumulated_generated += other.accumulated_generated;
+		accumulated_allocations += other.accumulated_allocations;
+		accumulated_runtime += other.accumulated_runtime;
+		other.num_of_searches = other.accumulated_expanded = other.accumulated_generated = 0;
+		other.accumulated_allocations = 0;
+		other.accumulated_runtime = 0;
+	}
 	SingleAgentSolver(): suboptimal_bound(1), num_expanded(0), num_generated(0), min_f_val(0), num_of_conf(0) {}
     virtual ~SingleAgentSolver()= default;
 
 protected:
 	double focal_bound;
+	vector<HeuristicView> goal_heuristics; // of the goals of the current search
+	vector<double> goal_suffix_h; // the distance from goal i through goals i + 1, i + 2, ... of the current search
+
+
+	// set runtime and add the statistics of the current search to the accumulated ones.
+	// runtime is wall time, since std::clock would include the searches running on other threads.
+	void record_search(std::chrono::steady_clock::time_point start)
+	{
+		runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		num_of_searches++;
+		accumulated_expanded += num_expanded;
+		accumulated_generated += num_generated;
+		accumulated_allocations += num_of_allocations;
+		accumulated_runtime += runtime;
+	}
 };
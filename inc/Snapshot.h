@@ -0,0 +1,39 @@
+#pragma once
+#include "common.h"
+
+
+// Serializes the location lists of a grid into the map snapshot (see BasicGraph::save_snapshot).
+// Values are written in the native byte order, as the snapshot is a local cache.
+class SnapshotWriter
+{
+public:
+    void write_int(int value);
+    void write_ints(const vector<int>& values);
+    void write_string(const string& str);
+
+    const string& get_data() const { return data; }
+
+private:
+    string data;
+};
+
+
+// Reads back what SnapshotWriter wrote. Reading past the end sets failed() instead of throwing,
+// so that a truncated snapshot is rejected like any other mismatch.
+class SnapshotReader
+{
+public:
+    SnapshotReader(const char* begin, const char* end): pos(begin), end(end) {}
+
+    int read_int();
+    vector<int> read_ints();
+    string read_string();
+
+    bool failed() const { return fail; }
+    bool at_end() const { return pos == end; } // everything was read
+
+private:
+    const char* pos;
+    const char* end;
+    bool fail = false;
+};
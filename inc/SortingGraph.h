@@ -11,4 +11,7 @@ public:
 
     bool load_map(string fname);
     void preprocessing(bool consider_rotation); // compute heuristics
+    void save_locations(SnapshotWriter& writer) const;
+    bool load_locations(SnapshotReader& reader);
+    string get_grid_type() const { return "SortingGrid"; }
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include "SingleAgentSolver.h"
+#include "SearchContext.h"
 
 
 class StateTimeAStarNode
@@ -45,6 +46,10 @@ public:
         handle_type open_handle;
     fibonacci_heap< StateTimeAStarNode*, compare<StateTimeAStarNode::secondary_compare_node> >::
         handle_type focal_handle;
+    // positions in the OPEN and FOCAL lists of the other queue policies (see SearchQueues.h)
+    int open_bucket = -1;
+    int open_position = -1;
+    int focal_position = -1;
 
     StateTimeAStarNode(): g_val(0), h_val(0), parent(nullptr), conflicts(0), depth(0), in_openlist(false), goal_id(0) {}
     StateTimeAStarNode(const State& state, double g_val, double h_val, StateTimeAStarNode* parent, int conflicts):
@@ -99,6 +104,14 @@ public:
             return State::Hasher()(n->state);
         }
     };
+
+    // the state packed into 64 bits, used by NodeTable instead of Hasher.
+    // The goal id is left out, since it changes when the node is expanded at its goal (EqNode compares it).
+    uint64_t get_key() const
+    {
+        return ((uint64_t)(uint32_t)state.location << 32) ^ ((uint64_t)(uint32_t)state.timestep << 3) ^
+               (uint64_t)(state.orientation + 1);
+    }
 };
 
 
@@ -110,6 +123,7 @@ public:
                   ReservationTable& RT);
 
 	string getName() const { return "AStar"; }
+	SingleAgentSolver* clone() const { StateTimeAStar* planner = new StateTimeAStar(); planner->copy_settings(*this); return planner; }
     void findTrajectory(BasicGraph& G,
                         const State& start,
                         const vector<pair<int, int> >& goal_locations,
@@ -118,12 +132,13 @@ public:
     StateTimeAStar(): SingleAgentSolver() {}
 
 private:
-	// define typedefs and handles for heap and hash_map
-	fibonacci_heap< StateTimeAStarNode*, compare<StateTimeAStarNode::compare_node> > open_list;
-	fibonacci_heap< StateTimeAStarNode*, compare<StateTimeAStarNode::secondary_compare_node> > focal_list;
-	unordered_set< StateTimeAStarNode*, StateTimeAStarNode::Hasher, StateTimeAStarNode::EqNode> allNodes_table;
+	SearchContext<StateTimeAStarNode> context; // the nodes and the OPEN and FOCAL lists, kept across searches
 	inline void releaseClosedListNodes();
 
+	template <typename Open, typename Focal>
+	Path search(BasicGraph& G, const State& start, const vector<pair<int, int> >& goal_location,
+	            ReservationTable& rt, Open& open_list, Focal& focal_list);
+
     // Updates the path
     Path updatePath(const StateTimeAStarNode* goal);
     list<pair<int, int> > updateTrajectory(const StateTimeAStarNode* goal);
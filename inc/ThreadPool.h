@@ -0,0 +1,47 @@
+#pragma once
+#include "common.h"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+// A fixed set of worker threads that run parallel loops.
+// The tasks of a loop are split into one deque per worker. A worker takes tasks from the back of its own deque
+// and, once that is empty, steals from the front of the others, so uneven tasks still keep every worker busy.
+// The calling thread takes part as worker 0, so a pool of one thread runs everything inline.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    int size() const { return num_threads; }
+
+    // call task(i, worker_id) for every i in [0, num_tasks) and return when all calls have finished
+    void parallel_for(int num_tasks, const std::function<void(int, int)>& task);
+
+private:
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        deque<int> tasks;
+    };
+
+    int num_threads;
+    vector<std::thread> workers;
+    vector<TaskQueue> queues;
+
+    std::mutex mutex;
+    std::condition_variable start_loop;
+    std::condition_variable finish_loop;
+    const std::function<void(int, int)>* current_task = nullptr;
+    uint64_t num_of_loops = 0; // used by the workers to detect a new loop
+    int num_of_busy_workers = 0;
+    bool stopped = false;
+
+    void work(int worker_id);
+    void run_tasks(int worker_id);
+    bool pop_task(int worker_id, int& task);
+};
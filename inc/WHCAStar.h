@@ -1,6 +1,7 @@
 #pragma once
 #include "SIPP.h"
 #include "MAPFSolver.h"
+#include "PrioritizedPlanner.h"
 #include <ctime>
 
 // WHCA* with random restart
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""Validates and benchmarks the jump point pruning of SIPP on a large fulfillment warehouse.
+
+The map has rows of long shelf blocks with pick locations on both sides, separated by open aisles, and home
+stations on the left and right (the layout of kiva.map, scaled up). The instance is first planned with
+--validate_jump_points, which repeats every search with jump points without them and fails if a path cost differs.
+Then it is planned with and without jump points, and the median of the low-level statistics is reported.
+
+    ./scripts/bench_jump_points.py --shelf_rows 30 --shelf_columns 12 --agents 400
+"""
+import argparse
+import statistics
+import subprocess
+import sys
+from pathlib import Path
+from tempfile import TemporaryDirectory
+from typing import List
+
+import pandas as pd
+
+from bench_planner import run_once
+
+STATS = [
+    "runtime_s",
+    "low_level_searches",
+    "low_level_expanded",
+    "low_level_runtime",
+]
+
+
+def write_fulfillment_map(shelf_rows: int, shelf_columns: int, shelf_length: int, output: Path) -> int:
+    """Write a kiva map with shelf_rows x shelf_columns shelf blocks and return its number of home stations."""
+    def shelf_row(cell: str) -> str:  # the shelf blocks are separated by one-cell cross aisles
+        return ".rr.rr." + ".".join([cell * shelf_length] * shelf_columns) + ".rr.rr."
+
+    aisle = "." * len(shelf_row("e"))
+    grid = [aisle]
+    for _ in range(shelf_rows):
+        grid += [shelf_row("e"), shelf_row("@"), shelf_row("e"), aisle]
+    num_of_endpoints = sum(row.count("e") for row in grid)
+    num_of_homes = sum(row.count("r") for row in grid)
+    header = [f"{len(grid)},{len(grid[0])}", str(num_of_endpoints), str(num_of_homes), "5000"]
+    output.write_text("\n".join(header + grid) + "\n")
+    return num_of_homes
+
+
+def main(
+    *,
+    shelf_rows: int,
+    shelf_columns: int,
+    shelf_length: int,
+    agents: int,
+    solver: str,
+    heuristic: str,
+    simulation_time: int,
+    planning_window: int,
+    seed: int,
+    repeats: int,
+    extra: List[str],
+) -> None:
+    with TemporaryDirectory() as tmpdir:
+        map_path = Path(tmpdir) / f"fulfillment_{shelf_rows}x{shelf_columns}.map"
+        num_of_homes = write_fulfillment_map(shelf_rows, shelf_columns, shelf_length, map_path)
+        if agents > num_of_homes:
+            sys.exit(f"The map has only {num_of_homes} home stations")
+        args = {
+            "solver": solver,
+            "agentNum": agents,
+            "heuristic": heuristic,
+            "simulation_time": simulation_time,
+            "planning_window": planning_window,
+            "seed": seed,
+        }
+        for item in extra:
+            key, _, extra_value = item.partition("=")
+            args[key] = extra_value
+
+        try:
+            validated = run_once(map_path, "KIVA", {**args, "jump_points": 1, "validate_jump_points": 1})
+        except subprocess.CalledProcessError:
+            sys.exit("Jump points changed the cost of a path")
+        print(f"Validated {int(validated['low_level_searches'])} searches with jump points against plain SIPP")
+
+        rows = []
+        for jump_points in [0, 1]:
+            runs = [run_once(map_path, "KIVA", {**args, "jump_points": jump_points}) for _ in range(repeats)]
+            row = {"jump_points": jump_points}
+            for key in STATS:
+                samples = [run[key] for run in runs if key in run]
+                row[key] = statistics.median(samples) if samples else None
+            rows.append(row)
+    print(pd.DataFrame(rows).to_string(index=False))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--shelf_rows", type=int, default=30, help="Rows of shelf blocks")
+    parser.add_argument("--shelf_columns", type=int, default=12, help="Shelf blocks in each row")
+    parser.add_argument("--shelf_length", type=int, default=10, help="Shelves in each block")
+    parser.add_argument("--agents", type=int, default=400)
+    parser.add_argument("--solver", type=str, default="PBS")
+    parser.add_argument("--heuristic", type=str, default="LANDMARK", help="Full tables do not fit large maps")
+    parser.add_argument("--simulation_time", type=int, default=50)
+    parser.add_argument("--planning_window", type=int, default=10)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--repeats", type=int, default=3, help="Runs with and without jump points (the median is reported)")
+    parser.add_argument("--extra", type=str, nargs="*", default=[], help="Other options as key=value")
+    main(**vars(parser.parse_args()))
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Compares the planner statistics for different values of one lifelong option.
+
+Every value of the option is run on the same instance (same map, agents, windows and seed), and the median of the
+selected stats.txt entries over the repeats is reported, e.g., to compare the reservation table backends:
+
+    ./scripts/bench_planner.py maps/sorting_map.grid --scenario=SORTING --agents 600 \\
+        --option constraint_table HASHED DENSE
+
+or the OPEN and FOCAL lists of the low-level planner:
+
+    ./scripts/bench_planner.py maps/kiva.map --scenario=KIVA --agents 200 --option queue FIBONACCI BUCKET HEAP
+"""
+import argparse
+import statistics
+import subprocess
+import time
+from pathlib import Path
+from tempfile import TemporaryDirectory
+from typing import Dict, List
+
+import pandas as pd
+
+from eval import RHCR_BINARY, load_stats
+
+DEFAULT_STATS = [
+    "reservation_table_runtime",
+    "low_level_runtime",
+    "low_level_nodes_per_sec",
+]
+
+
+def run_once(map_path: Path, scenario: str, args: Dict[str, str]) -> Dict[str, float]:
+    with TemporaryDirectory() as tmpdir:
+        command = [RHCR_BINARY, f"--scenario={scenario}", f"--map={map_path}", f"--output={tmpdir}", "--screen=0"]
+        command += [f"--{key}={value}" for key, value in args.items()]
+        start_time = time.perf_counter()
+        subprocess.run([str(c) for c in command], check=True, stdout=subprocess.DEVNULL)
+        runtime_s = time.perf_counter() - start_time
+        stats = {"runtime_s": runtime_s}
+        for key, value in load_stats(Path(tmpdir) / "stats.txt").items():
+            try:
+                stats[key] = float(value)
+            except ValueError:
+                pass
+        return stats
+
+
+def main(
+    *,
+    map_path: Path,
+    scenario: str,
+    solver: str,
+    agents: int,
+    simulation_time: int,
+    simulation_window: int,
+    planning_window: int,
+    seed: int,
+    repeats: int,
+    option: List[str],
+    extra: List[str],
+    stats: List[str],
+) -> None:
+    name, values = option[0], option[1:]
+    rows = []
+    for value in values:
+        args = {
+            "solver": solver,
+            "agentNum": agents,
+            "simulation_time": simulation_time,
+            "simulation_window": simulation_window,
+            "planning_window": planning_window,
+            "seed": seed,
+            name: value,
+        }
+        for item in extra:
+            key, _, extra_value = item.partition("=")
+            args[key] = extra_value
+        runs = [run_once(map_path, scenario, args) for _ in range(repeats)]
+        row = {name: value}
+        for key in ["runtime_s"] + stats:
+            samples = [run[key] for run in runs if key in run]
+            row[key] = statistics.median(samples) if samples else None
+        rows.append(row)
+    print(pd.DataFrame(rows).to_string(index=False))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("map_path", type=Path, help="Path to the map file")
+    parser.add_argument("--scenario", type=str, default="KIVA", help="KIVA, SORTING, ONLINE, BEE or MT")
+    parser.add_argument("--solver", type=str, default="PBS")
+    parser.add_argument("--agents", type=int, default=500)
+    parser.add_argument("--simulation_time", type=int, default=50)
+    parser.add_argument("--simulation_window", type=int, default=5)
+    parser.add_argument("--planning_window", type=int, default=10)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--repeats", type=int, default=3, help="Runs per option value (the median is reported)")
+    parser.add_argument("--option", type=str, nargs="+", required=True, help="Option name followed by its values")
+    parser.add_argument("--extra", type=str, nargs="*", default=[], help="Other options as key=value")
+    parser.add_argument("--stats", type=str, nargs="+", default=DEFAULT_STATS, help="stats.txt entries to report")
+    main(**vars(parser.parse_args()))
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Measures how prioritized planning scales with the number of agents.
+
+The map is the kiva warehouse tiled into a larger one (8x8 copies hold 12288 agents), and every number of agents
+is planned once by WHCA* (one prioritized sweep per restart). The reservation table time per build should stay
+flat as the number of agents grows, since every planned path is appended to one table.
+
+    ./scripts/bench_prioritized.py maps/kiva.map --agents 500 1000 2000 5000
+"""
+import argparse
+import statistics
+from pathlib import Path
+from tempfile import TemporaryDirectory
+from typing import List
+
+import pandas as pd
+
+from bench_planner import run_once
+
+STATS = [
+    "runtime_s",
+    "reservation_table_builds",
+    "reservation_table_runtime",
+    "low_level_runtime",
+]
+
+
+def tile_kiva_map(map_path: Path, tiles: int, output: Path) -> int:
+    """Write a kiva map made of tiles x tiles copies of map_path and return its number of home stations."""
+    lines = map_path.read_text().splitlines()
+    rows, _ = (int(x) for x in lines[0].split(","))
+    grid = [row * tiles for _ in range(tiles) for row in lines[4 : 4 + rows]]
+    num_of_endpoints = sum(row.count("e") for row in grid)
+    num_of_homes = sum(row.count("r") for row in grid)
+    header = [f"{len(grid)},{len(grid[0])}", str(num_of_endpoints), str(num_of_homes), lines[3]]
+    output.write_text("\n".join(header + grid) + "\n")
+    return num_of_homes
+
+
+def main(
+    *,
+    map_path: Path,
+    tiles: int,
+    agents: List[int],
+    solver: str,
+    heuristic: str,
+    planning_window: int,
+    seed: int,
+    repeats: int,
+) -> None:
+    with TemporaryDirectory() as tmpdir:
+        big_map = Path(tmpdir) / f"{map_path.stem}_{tiles}x{tiles}.map"
+        num_of_homes = tile_kiva_map(map_path, tiles, big_map)
+        rows = []
+        for num_of_agents in agents:
+            if num_of_agents > num_of_homes:
+                print(f"Skip {num_of_agents} agents: the map has {num_of_homes} home stations")
+                continue
+            args = {
+                "solver": solver,
+                "agentNum": num_of_agents,
+                "heuristic": heuristic,
+                "simulation_time": 1,
+                "simulation_window": 1,
+                "planning_window": planning_window,
+                "seed": seed,
+            }
+            runs = [run_once(big_map, "KIVA", args) for _ in range(repeats)]
+            row = {"agents": num_of_agents}
+            for key in STATS:
+                samples = [run[key] for run in runs if key in run]
+                row[key] = statistics.median(samples) if samples else None
+            if row["reservation_table_builds"]:
+                row["reservation_table_us_per_build"] = (
+                    1e6 * row["reservation_table_runtime"] / row["reservation_table_builds"]
+                )
+            rows.append(row)
+    print(pd.DataFrame(rows).to_string(index=False))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("map_path", type=Path, help="Path to a kiva map, which is tiled")
+    parser.add_argument("--tiles", type=int, default=8, help="Copies of the map in each dimension")
+    parser.add_argument("--agents", type=int, nargs="+", default=[500, 1000, 2000, 5000])
+    parser.add_argument("--solver", type=str, default="WHCA")
+    parser.add_argument("--heuristic", type=str, default="LANDMARK", help="Full tables do not fit large maps")
+    parser.add_argument("--planning_window", type=int, default=10)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--repeats", type=int, default=3, help="Runs per number of agents (the median is reported)")
+    main(**vars(parser.parse_args()))
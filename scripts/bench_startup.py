@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Measures how long the heuristic tables take to precompute for different numbers of threads.
+
+Every run copies the map into a fresh temporary directory, so no cached heuristic table is found
+and all tables are recomputed. The simulation itself is skipped (--simulation_time=0).
+"""
+import argparse
+import shutil
+import statistics
+import subprocess
+from pathlib import Path
+from tempfile import TemporaryDirectory
+from typing import List
+
+import pandas as pd
+
+from eval import RHCR_BINARY, load_stats
+
+
+def run_once(map_path: Path, scenario: str, threads: int, rotation: bool) -> float:
+    with TemporaryDirectory() as tmpdir:
+        map_copy = Path(tmpdir) / map_path.name
+        shutil.copy(map_path, map_copy)
+        output = Path(tmpdir) / "output"
+        command = [
+            RHCR_BINARY,
+            f"--scenario={scenario}",
+            f"--map={map_copy}",
+            "--agentNum=1",
+            "--simulation_time=0",
+            f"--rotation={int(rotation)}",
+            f"--threads={threads}",
+            f"--output={output}",
+        ]
+        subprocess.run([str(c) for c in command], check=True, stdout=subprocess.DEVNULL)
+        return float(load_stats(output / "stats.txt")["heuristic_precomputing_time"])
+
+
+def main(*, map_path: Path, scenario: str, threads: List[int], repeats: int, rotation: bool) -> None:
+    rows = []
+    for num_threads in threads:
+        times = [run_once(map_path, scenario, num_threads, rotation) for _ in range(repeats)]
+        rows.append({"threads": num_threads, "precomputing_time_s": statistics.median(times)})
+    df = pd.DataFrame(rows)
+    df["speedup"] = df["precomputing_time_s"].iloc[0] / df["precomputing_time_s"]
+    print(df.to_string(index=False))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("map_path", type=Path, help="Path to the map file")
+    parser.add_argument("--scenario", type=str, default="KIVA", help="KIVA, SORTING or ONLINE")
+    parser.add_argument("--threads", type=int, nargs="+", default=[1, 2, 4, 8, 16])
+    parser.add_argument("--repeats", type=int, default=3, help="Runs per thread count (the median is reported)")
+    parser.add_argument("--rotation", action="store_true", default=False)
+    main(**vars(parser.parse_args()))
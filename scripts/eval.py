@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 import argparse
 import datetime
+import itertools
 import os
 import signal
 import subprocess
@@ -26,6 +27,20 @@ class RHCRResult:
     return_code: int
     completed_tasks: Optional[int]
     runtime_s: Optional[float]
+    stats: Dict[str, str]
+
+
+def load_stats(stats_path: Path) -> Dict[str, str]:
+    """Reads the "key: value" lines written by BasicSystem::save_statistics."""
+    stats: Dict[str, str] = {}
+    if not stats_path.exists():
+        return stats
+    with open(stats_path, "r") as f:
+        for line in f:
+            key, sep, value = line.partition(":")
+            if sep:
+                stats[key.strip()] = value.strip()
+    return stats
 
 
 def run_instance(
@@ -57,8 +72,9 @@ def run_instance(
             if rv == 0:
                 with open(Path(tmpdir) / "tasks.txt", "r") as f:
                     num_completed = int(f.readlines()[-1].split(" ")[-1].strip())
-                return RHCRResult(instance, rv, num_completed, runtime_s)
-            return RHCRResult(instance, rv, None, None)
+                stats = load_stats(Path(tmpdir) / "stats.txt")
+                return RHCRResult(instance, rv, num_completed, runtime_s, stats)
+            return RHCRResult(instance, rv, None, None, {})
     except subprocess.CalledProcessError as e:
         print(f"Instance failed with error:\n{e.stderr}")
         return None
@@ -82,23 +98,29 @@ def main(*, config_path: Path, dry_run: bool) -> None:
 
     instances: List[Dict[str, Any]] = []
 
+    # optional command-line options to sweep over, e.g. {"heuristic": ["MANHATTAN", "SHORTEST_PATH"]}
+    option_names = list(config.get("options", {}).keys())
+    option_values = list(itertools.product(*config.get("options", {}).values()))
+
     for solver_name, solver_info in config["solvers"].items():
         for map in config["maps"]:
             for simulation_window in config["simulation_windows"]:
                 for num_agents in solver_info["num_agents"]:
                     for seed in range(config["n_seeds"]):
-                        instances.append(
-                            {
-                                "scenario": "MT",
-                                "solver": solver_name,
-                                "map": MAPS_DIR / map,
-                                "agentNum": num_agents,
-                                "simulation_window": simulation_window,
-                                "planning_window": simulation_window * 2,
-                                "seed": seed,
-                                "simulation_time": config["simulation_time"],
-                            }
-                        )
+                        for values in option_values:
+                            instances.append(
+                                {
+                                    "scenario": config.get("scenario", "MT"),
+                                    "solver": solver_name,
+                                    "map": MAPS_DIR / map,
+                                    "agentNum": num_agents,
+                                    "simulation_window": simulation_window,
+                                    "planning_window": simulation_window * 2,
+                                    "seed": seed,
+                                    "simulation_time": config["simulation_time"],
+                                    **dict(zip(option_names, values)),
+                                }
+                            )
 
     max_workers = config.get("max_workers", 1)
     print(f"Running {len(instances)} instances across {max_workers} workers")
@@ -128,6 +150,7 @@ def main(*, config_path: Path, dry_run: bool) -> None:
                 **result.config,
                 "completed_tasks": result.completed_tasks,
                 "runtime_s": result.runtime_s,
+                **result.stats,
             }
             for result in results
         ]
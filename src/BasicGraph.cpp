@@ -1,10 +1,16 @@
 #include "BasicGraph.h"
 #include <fstream>
 #include <boost/tokenizer.hpp>
-#include "StateTimeAStar.h"
+#include "DistanceEngine.h"
+#include "ThreadPool.h"
 #include <sstream>
 #include <random>
 #include <chrono>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
 
 
 void BasicGraph::print_map() const
@@ -15,7 +21,7 @@ void BasicGraph::print_map() const
     std::cout << std::endl;
 
     std::cout << "***weights***" << std::endl;
-    for (std::vector<double> n : weights)
+    for (const auto& n : weights)
     {
         for (double w : n)
         {
@@ -37,28 +43,28 @@ int BasicGraph::get_rotate_degree(int dir1, int dir2) const
 }
 
 
-list<int> BasicGraph::get_neighbors(int v) const
+NeighborList<int> BasicGraph::get_neighbors(int v) const
 {
-    list<int> neighbors;
+    NeighborList<int> neighbors;
     if (v < 0)
         return neighbors;
 
     for (int i = 0; i < 4; i++) // move
-        if (weights[v][i] < WEIGHT_MAX - 1)
+        if (valid_move(v, i))
             neighbors.push_back(v + move[i]);
 
     return neighbors;
 }
 
-list<State> BasicGraph::get_neighbors(const State& s) const
+NeighborList<State> BasicGraph::get_neighbors(const State& s) const
 {
-    list<State> neighbors;
+    NeighborList<State> neighbors;
     if (s.location < 0)
         return neighbors;
     if (s.orientation >= 0)
     {
         neighbors.push_back(State(s.location, s.timestep + 1, s.orientation)); // wait
-        if (weights[s.location][s.orientation] < WEIGHT_MAX - 1)
+        if (valid_move(s.location, s.orientation))
             neighbors.push_back(State(s.location + move[s.orientation], s.timestep + 1, s.orientation)); // move
         int next_orientation1 = s.orientation + 1;
         int next_orientation2 = s.orientation - 1;
@@ -73,20 +79,20 @@ list<State> BasicGraph::get_neighbors(const State& s) const
     {
         neighbors.push_back(State(s.location, s.timestep + 1)); // wait
         for (int i = 0; i < 4; i++) // move
-            if (weights[s.location][i] < WEIGHT_MAX - 1)
+            if (valid_move(s.location, i))
                 neighbors.push_back(State(s.location + move[i], s.timestep + 1));
     }
     return neighbors;
 }    
 
-std::list<State> BasicGraph::get_reverse_neighbors(const State& s) const
+NeighborList<State> BasicGraph::get_reverse_neighbors(const State& s) const
 {
-    std::list<State> rneighbors;
+    NeighborList<State> rneighbors;
     // no wait actions
     if (s.orientation >= 0)
     {
         if (s.location - move[s.orientation] >= 0 && s.location - move[s.orientation] < this->size() &&
-            weights[s.location - move[s.orientation]][s.orientation] < WEIGHT_MAX - 1)
+            valid_move(s.location - move[s.orientation], s.orientation))
             rneighbors.push_back(State(s.location - move[s.orientation], -1, s.orientation)); // move
         int next_orientation1 = s.orientation + 1;
         int next_orientation2 = s.orientation - 1;
@@ -101,13 +107,120 @@ std::list<State> BasicGraph::get_reverse_neighbors(const State& s) const
     {
         for (int i = 0; i < 4; i++) // move
             if (s.location - move[i] >= 0 && s.location - move[i] < this->size() &&
-                    weights[s.location - move[i]][i] < WEIGHT_MAX - 1)
+                    valid_move(s.location - move[i], i))
                 rneighbors.push_back(State(s.location - move[i]));
     }
     return rneighbors;
 }
 
 
+void BasicGraph::update_valid_moves()
+{
+    valid_moves.assign(weights.size(), 0);
+    distance_engine.reset(); // it picks its search method by the weights
+    integer_weights = true;
+    uniform_weights = true;
+    double weight = -1; // the weight of the first allowed move or wait
+    for (int loc = 0; loc < (int)weights.size(); loc++)
+    {
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int next = loc + move[dir];
+            if (weights[loc][dir] < WEIGHT_MAX - 1 && 0 <= next && next < this->size() &&
+                get_Manhattan_distance(loc, next) == 1)
+                valid_moves[loc] |= 1 << dir;
+        }
+        if (weights[loc][4] < WEIGHT_MAX - 1)
+            valid_moves[loc] |= 1 << 4;
+        for (int dir = 0; dir < 5; dir++)
+        {
+            if (valid_move(loc, dir) && weights[loc][dir] != std::floor(weights[loc][dir]))
+                integer_weights = false;
+        }
+    }
+    for (int loc = 0; loc < (int)weights.size() && uniform_weights; loc++)
+    {
+        for (int dir = 0; dir < 4; dir++)
+        {
+            if (!valid_move(loc, dir))
+                continue;
+            if (weight < 0)
+                weight = weights[loc][dir];
+            if (weights[loc][dir] != weight || !valid_move(loc, 4) || weights[loc][4] != weight ||
+                !valid_move(loc + move[dir], (dir + 2) % 4))
+                uniform_weights = false;
+        }
+    }
+}
+
+
+cell_type BasicGraph::get_cell_type(const MapToken& type)
+{
+    for (int i = 0; i < CELL_TYPE_COUNT; i++)
+    {
+        if (type == get_type_name((cell_type)i))
+            return (cell_type)i;
+    }
+    return TRAVEL;
+}
+
+
+const char* BasicGraph::get_type_name(cell_type type)
+{
+    static const char* names[CELL_TYPE_COUNT] = {"Travel", "Obstacle", "Endpoint", "Home", "Induct", "Eject",
+                                                 "Entry", "Exit", "Magic"};
+    return names[type];
+}
+
+
+void BasicGraph::set_size(int rows, int cols)
+{
+    this->rows = rows;
+    this->cols = cols;
+    move[0] = 1;
+    move[1] = -cols;
+    move[2] = -1;
+    move[3] = cols;
+    cell_types.assign(rows * cols, TRAVEL);
+    std::array<double, 5> blocked;
+    blocked.fill(WEIGHT_MAX);
+    weights.assign(rows * cols, blocked);
+}
+
+
+void BasicGraph::connect_free_cells(double move_weight)
+{
+    for (int loc = 0; loc < rows * cols; loc++)
+    {
+        if (is_type(loc, OBSTACLE))
+            continue;
+        for (int dir = 0; dir < 4; dir++)
+        {
+            int next = loc + move[dir];
+            if (0 <= next && next < rows * cols && get_Manhattan_distance(loc, next) <= 1 && !is_type(next, OBSTACLE))
+                weights[loc][dir] = move_weight;
+        }
+    }
+}
+
+
+void BasicGraph::finish_loading(const MapParser& parser)
+{
+    update_valid_moves();
+    update_type_names();
+    map_loading_time = parser.get_runtime();
+    map_file_size = parser.size();
+}
+
+
+void BasicGraph::update_type_names()
+{
+    types.resize(cell_types.size());
+    for (int loc = 0; loc < (int)cell_types.size(); loc++)
+        types[loc] = get_type_name(get_type(loc));
+}
+
+
 double BasicGraph::get_weight(int from, int to) const
 {
     if (from == to) // wait or rotate
@@ -122,11 +235,15 @@ double BasicGraph::get_weight(int from, int to) const
 
 int BasicGraph::get_direction(int from, int to) const
 {
-    for (int i = 0; i < 4; i++)
-    {
-        if (move[i] == to - from)
-            return i;
-    }
+    int diff = to - from; // checked in the order of move[]
+    if (diff == move[0])
+        return 0;
+    if (diff == move[1])
+        return 1;
+    if (diff == move[2])
+        return 2;
+    if (diff == move[3])
+        return 3;
     if (from == to)
         return 4;
     return -1;
@@ -134,8 +251,79 @@ int BasicGraph::get_direction(int from, int to) const
 
 
 
-bool BasicGraph::load_heuristics_table(std::ifstream& myfile)
+// Heuristics format of the map snapshot: a header, the root location of every table (the goal index),
+// then the tables in the same order, each holding size() int32 distances.
+#define HEURISTICS_FILE_VERSION 1
+struct HeuristicsFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t heuristic; // heuristic_mode
+    uint32_t rotation;
+    int32_t rows;
+    int32_t cols;
+    uint32_t num_of_tables;
+    uint64_t map_hash;
+};
+static const char HEURISTICS_FILE_MAGIC[8] = {'R', 'H', 'C', 'R', 'H', 'E', 'U', 'R'};
+
+
+bool BasicGraph::load_heuristics_table()
 {
+    if (heuristic == LANDMARK) // the landmark tables are not cached
+        return false;
+    if (loaded_from_snapshot) // the tables came with the map snapshot
+        return true;
+    auto start = std::chrono::steady_clock::now();
+    bool succ = false;
+    if (heuristic == SHORTEST_PATH && import_heuristics_table(get_legacy_heuristics_table_name()))
+    {
+        std::cout << "Imported the heuristic tables from " << get_legacy_heuristics_table_name() << std::endl;
+        succ = true;
+    }
+    heuristics_loading_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return succ;
+}
+
+
+bool BasicGraph::map_heuristics(const std::shared_ptr<MappedFile>& file, size_t offset, const std::string& fname)
+{
+    if (file->size() < offset + sizeof(HeuristicsFileHeader))
+        return false;
+    HeuristicsFileHeader header;
+    memcpy(&header, file->data() + offset, sizeof(header));
+    if (memcmp(header.magic, HEURISTICS_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != HEURISTICS_FILE_VERSION)
+    {
+        std::cout << "Heuristics file " << fname << " has an unknown format" << std::endl;
+        return false;
+    }
+    size_t expected_size = sizeof(header) + sizeof(int32_t) * header.num_of_tables * (1 + (size_t)this->size());
+    if (header.heuristic != (uint32_t)heuristic || header.rotation != (uint32_t)consider_rotation ||
+        header.rows != rows || header.cols != cols || header.map_hash != get_map_hash() ||
+        file->size() - offset != expected_size)
+    {
+        std::cout << "Heuristics file " << fname << " does not match the map" << std::endl;
+        return false;
+    }
+
+    const int32_t* roots = reinterpret_cast<const int32_t*>(file->data() + offset + sizeof(header));
+    const int32_t* tables = roots + header.num_of_tables;
+    for (uint32_t i = 0; i < header.num_of_tables; i++)
+    {
+        if (!heuristics.contains(roots[i]))
+            heuristics.insert(roots[i], HeuristicTable(tables + (size_t)i * this->size(), this->size()));
+    }
+    return true;
+}
+
+
+// the text format of older versions
+bool BasicGraph::import_heuristics_table(const std::string& fname)
+{
+    std::ifstream myfile(fname.c_str());
+    if (!myfile.is_open())
+        return false;
     boost::char_separator<char> sep(",");
     boost::tokenizer< boost::char_separator<char> >::iterator beg;
     std::string line;
@@ -149,6 +337,7 @@ bool BasicGraph::load_heuristics_table(std::ifstream& myfile)
 	int M = atoi ( (*beg).c_str() ); // read number of rows
 	if (M != this->size())
 	    return false;
+	vector<pair<int, vector<int> > > tables(N);
 	for (int i = 0; i < N; i++)
 	{
 		getline (myfile, line);
@@ -156,118 +345,392 @@ bool BasicGraph::load_heuristics_table(std::ifstream& myfile)
         getline (myfile, line);        
         boost::tokenizer< boost::char_separator<char> > tok(line, sep);
 	    beg = tok.begin();
-        std::vector<double> h_table(this->size());
+        tables[i].first = loc;
+        std::vector<int>& h_table = tables[i].second;
+        h_table.resize(this->size());
         for (int j = 0; j < this->size(); j++)
         {
-            h_table[j] = atof((*beg).c_str());
-            if (h_table[j] >= INT_MAX && types[j] != "Obstacle")
-                types[j] = "Obstacle";
+            double h = atof((*beg).c_str());
+            h_table[j] = h >= INT_MAX ? INT_MAX : (int)h;
             beg++;
         }
-        heuristics[loc] = h_table;
     }
+	myfile.close();
+	// Some older versions wrote Manhattan distances under the same name.
+	// Shortest-path tables equal them as well where the root is in plain view, so only a file
+	// where every table does is suspicious. It is then checked against one recomputed table
+	// with a location behind an obstacle in line with the root, where the Manhattan distance is too short.
+	bool manhattan = true;
+	for (int i = 0; i < N && manhattan; i++)
+	{
+		for (int j = 0; j < this->size() && manhattan; j++)
+			manhattan = tables[i].second[j] == INT_MAX || tables[i].second[j] == get_Manhattan_distance(j, tables[i].first);
+	}
+	for (int i = 0; i < N && manhattan; i++)
+	{
+		if (has_hidden_location(tables[i].first, tables[i].second))
+		{
+			if (compute_heuristics(tables[i].first) != tables[i].second)
+			{
+				std::cout << "Heuristics file " << fname << " holds Manhattan distances" << std::endl;
+				return false;
+			}
+			break;
+		}
+	}
+	for (auto& table : tables)
+	{
+		for (int j = 0; j < this->size(); j++)
+		{
+			if (table.second[j] == INT_MAX && !is_type(j, OBSTACLE))
+			{
+				types[j] = "Obstacle";
+				cell_types[j] = OBSTACLE;
+			}
+		}
+		heuristics.insert(table.first, HeuristicTable(table.second));
+	}
 	return true;
 }
 
 
-void BasicGraph::save_heuristics_table(std::string fname)
+// Whether a reachable location in the same row or column as the root cannot move straight to it,
+// so that its distance to the root is more than their Manhattan distance (with unit weights).
+bool BasicGraph::has_hidden_location(int root_location, const std::vector<int>& distances) const
 {
-    std::ofstream myfile;
-	myfile.open (fname);
-	myfile << "table_size" << std::endl << 
-        heuristics.size() << "," << this->size() << std::endl;
-	for (auto h_values: heuristics) 
-	{
-        myfile << h_values.first << std::endl;
-		for (double h : h_values.second) 
-		{
-            myfile << h << ",";
-		}
-		myfile << std::endl;
-	}
-	myfile.close();
+    for (int direction = 0; direction < 4; direction++)
+    {
+        bool blocked = false;
+        for (int loc = root_location, next = loc + move[direction];
+             0 <= next && next < this->size() && get_Manhattan_distance(loc, next) == 1;
+             loc = next, next += move[direction])
+        {
+            blocked = blocked || !valid_move(next, get_direction(next, loc));
+            if (blocked && distances[next] != INT_MAX)
+                return true;
+        }
+    }
+    return false;
+}
+
+
+void BasicGraph::write_heuristics(std::ostream& out) const
+{
+    std::vector<int> roots = heuristics.get_root_locations();
+
+    HeuristicsFileHeader header;
+    memcpy(header.magic, HEURISTICS_FILE_MAGIC, sizeof(header.magic));
+    header.version = HEURISTICS_FILE_VERSION;
+    header.heuristic = (uint32_t)heuristic;
+    header.rotation = (uint32_t)consider_rotation;
+    header.rows = rows;
+    header.cols = cols;
+    header.num_of_tables = (uint32_t)roots.size();
+    header.map_hash = get_map_hash();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int root : roots)
+    {
+        int32_t loc = root;
+        out.write(reinterpret_cast<const char*>(&loc), sizeof(loc));
+    }
+    std::vector<int> distances;
+    for (int root : roots)
+    {
+        heuristics.at(root).copy_to(distances);
+        out.write(reinterpret_cast<const char*>(distances.data()), sizeof(int32_t) * distances.size());
+    }
+}
+
+
+// Map snapshot: a header, the cell types (padded to 8 bytes), the edge weights, the location lists
+// written by save_locations, and the heuristic tables in the heuristics file format (at an 8-byte boundary).
+#define SNAPSHOT_FILE_VERSION 2
+struct SnapshotFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t rotation;
+    char grid_type[16]; // get_grid_type(), padded with zeros
+    uint64_t content_hash; // of the map file
+    int32_t rows;
+    int32_t cols;
+    uint64_t locations_size;
+    uint64_t heuristics_offset;
+};
+static const char SNAPSHOT_FILE_MAGIC[8] = {'R', 'H', 'C', 'R', 'S', 'N', 'A', 'P'};
+
+static size_t align8(size_t size) { return (size + 7) & ~(size_t)7; }
+
+
+bool BasicGraph::load_snapshot(const std::string& map_fname)
+{
+    auto start = std::chrono::steady_clock::now();
+    map_name = map_fname.substr(0, map_fname.rfind('.'));
+    MappedFile map_file;
+    if (!map_file.open(map_fname))
+        return false;
+    map_content_hash = map_file.get_content_hash();
+
+    std::string fname = get_snapshot_name();
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(fname) || file->size() < sizeof(SnapshotFileHeader))
+        return false;
+    SnapshotFileHeader header;
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_FILE_VERSION)
+    {
+        std::cout << "Map snapshot " << fname << " has an unknown format" << std::endl;
+        return false;
+    }
+    if (header.content_hash != map_content_hash || header.rotation != (uint32_t)consider_rotation)
+    {
+        std::cout << "Map snapshot " << fname << " is out of date" << std::endl;
+        return false;
+    }
+    if (get_grid_type().compare(0, string::npos, header.grid_type, strnlen(header.grid_type, sizeof(header.grid_type))) != 0)
+    {
+        std::cout << "Map snapshot " << fname << " was written for another scenario" << std::endl;
+        return false;
+    }
+    size_t num_of_cells = (size_t)header.rows * header.cols;
+    size_t weights_offset = sizeof(header) + align8(num_of_cells);
+    size_t locations_offset = weights_offset + num_of_cells * sizeof(weights[0]);
+    if (header.rows <= 0 || header.cols <= 0 || locations_offset + header.locations_size > header.heuristics_offset ||
+        header.heuristics_offset > file->size())
+    {
+        std::cout << "Map snapshot " << fname << " is corrupted" << std::endl;
+        return false;
+    }
+
+    std::cout << "*** Loading map snapshot ***" << std::endl;
+    set_size(header.rows, header.cols);
+    memcpy(cell_types.data(), file->data() + sizeof(header), num_of_cells);
+    memcpy(weights.data(), file->data() + weights_offset, num_of_cells * sizeof(weights[0]));
+    update_valid_moves();
+    update_type_names();
+    // tables that were mapped stay valid even if the location lists are rejected, as they only depend on the weights
+    if (!map_heuristics(file, header.heuristics_offset, fname))
+        return false;
+    snapshot_file = file;
+    SnapshotReader reader(file->data() + locations_offset, file->data() + locations_offset + header.locations_size);
+    if (!load_locations(reader) || reader.failed() || !reader.at_end())
+    {
+        std::cout << "Map snapshot " << fname << " is corrupted" << std::endl;
+        return false;
+    }
+
+    loaded_from_snapshot = true;
+    map_loading_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    map_file_size = map_file.size();
+    std::cout << "Map size: " << rows << "x" << cols << " with " << heuristics.size() << " heuristic tables" << std::endl;
+    std::cout << "Done! (" << map_loading_time << " s)" << std::endl;
+    return true;
+}
+
+
+void BasicGraph::save_snapshot() const
+{
+    if (loaded_from_snapshot || map_content_hash == 0)
+        return;
+    SnapshotWriter locations;
+    save_locations(locations);
+
+    size_t num_of_cells = cell_types.size();
+    SnapshotFileHeader header;
+    memcpy(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_FILE_VERSION;
+    header.rotation = (uint32_t)consider_rotation;
+    memset(header.grid_type, 0, sizeof(header.grid_type));
+    get_grid_type().copy(header.grid_type, sizeof(header.grid_type));
+    header.content_hash = map_content_hash;
+    header.rows = rows;
+    header.cols = cols;
+    header.locations_size = locations.get_data().size();
+    size_t locations_offset = sizeof(header) + align8(num_of_cells) + num_of_cells * sizeof(weights[0]);
+    header.heuristics_offset = align8(locations_offset + header.locations_size);
+
+    // write to a temporary file first, so that other processes never map a partially written file
+    std::string fname = get_snapshot_name();
+    std::string tmp_fname = fname + "." + std::to_string(getpid()) + ".tmp";
+    std::ofstream myfile(tmp_fname, std::ios::binary);
+    const char padding[8] = {0};
+    myfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    myfile.write(reinterpret_cast<const char*>(cell_types.data()), num_of_cells);
+    myfile.write(padding, align8(num_of_cells) - num_of_cells);
+    myfile.write(reinterpret_cast<const char*>(weights.data()), num_of_cells * sizeof(weights[0]));
+    myfile.write(locations.get_data().data(), header.locations_size);
+    myfile.write(padding, header.heuristics_offset - locations_offset - header.locations_size);
+    write_heuristics(myfile);
+    myfile.close();
+    if (!myfile || std::rename(tmp_fname.c_str(), fname.c_str()) != 0)
+    {
+        std::cout << "Fail to save the map snapshot to " << fname << std::endl;
+        std::remove(tmp_fname.c_str());
+    }
+}
+
+
+uint64_t BasicGraph::get_map_hash() const
+{
+    // FNV-1a over 64-bit words
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](uint64_t word)
+    {
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    };
+    add((uint64_t)rows);
+    add((uint64_t)cols);
+    for (const auto& w : weights)
+    {
+        for (double value : w)
+        {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            add(bits);
+        }
+    }
+    return hash;
 }
 
-std::vector<double> BasicGraph::get_heuristic(int root_location)
+
+HeuristicView BasicGraph::get_heuristic(int root_location)
 {
-    if(heuristics.find(root_location) == heuristics.end())
+    if (heuristic == LANDMARK)
+    {
+        if (landmarks.empty())
+            precompute_heuristics(std::vector<int>());
+        return HeuristicView(landmarks, root_location, this->size());
+    }
+    const HeuristicTable* table = heuristics.find(root_location);
+    if (table == nullptr)
     {
-        heuristics[root_location] = compute_heuristics(root_location);
+        std::vector<int> distances;
+        compute_heuristics(root_location, distances, get_distance_engine());
+        table = &heuristics.insert(root_location, HeuristicTable(distances));
     }
-    return heuristics[root_location];
+    return HeuristicView(*table);
+}
+
+std::vector<int> BasicGraph::compute_heuristics(int root_location)
+{
+    std::vector<int> res;
+    compute_heuristics(root_location, res, get_distance_engine());
+    return res;
 }
 
-std::vector<double> BasicGraph::compute_heuristics(int root_location)
+DistanceEngine& BasicGraph::get_distance_engine()
 {
-    if (true)
+    if (distance_engine == nullptr)
+        distance_engine = std::make_shared<DistanceEngine>(*this);
+    return *distance_engine;
+}
+
+void BasicGraph::compute_heuristics(int root_location, std::vector<int>& distances, DistanceEngine& engine) const
+{
+    if (heuristic == MANHATTAN)
     {
-        std::vector<double> res(this->size(), DBL_MAX);
-        for (size_t i = 0; i < this->size(); i++)
+        distances.assign(this->size(), INT_MAX);
+        for (int i = 0; i < this->size(); i++)
         {
-            if (types[i] == "Obstacle")
+            if (is_type(i, OBSTACLE))
                 continue;
-            res[i] = get_Manhattan_distance(i, root_location);
+            distances[i] = get_Manhattan_distance(i, root_location);
         }
-        return res;
+        return;
     }
-    std::vector<double> res(this->size(), DBL_MAX);
-	fibonacci_heap< StateTimeAStarNode*, compare<StateTimeAStarNode::compare_node> > heap;
-    unordered_set< StateTimeAStarNode*, StateTimeAStarNode::Hasher, StateTimeAStarNode::EqNode> nodes;
+    engine.compute(root_location, distances);
+}
 
-    State root_state(root_location);
-    if(consider_rotation)
+
+void BasicGraph::precompute_heuristics(const std::vector<int>& root_locations)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (heuristic == LANDMARK)
     {
-        for (auto neighbor : get_reverse_neighbors(root_state))
+        if (landmarks.empty())
+            landmarks.build(*this, num_of_landmarks);
+        double runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        precomputing_time += runtime;
+        std::cout << "Computed " << landmarks.size() << " landmark tables (" << runtime << " s)" << std::endl;
+        return;
+    }
+    std::vector<int> roots;
+    unordered_set<int> added;
+    for (int root : root_locations)
+    {
+        if (!heuristics.contains(root) && added.insert(root).second)
+            roots.push_back(root);
+    }
+    if (heuristics.memory_budget > 0)
+    {
+        // skip the tables that would be evicted anyway; they are computed on demand
+        size_t table_memory = this->size() * sizeof(uint16_t);
+        size_t free_memory = heuristics.memory_budget > heuristics.memory_usage() ?
+                heuristics.memory_budget - heuristics.memory_usage() : 0;
+        size_t max_num_of_tables = max(free_memory / table_memory, (size_t)1);
+        if (roots.size() > max_num_of_tables)
         {
-            StateTimeAStarNode* root = new StateTimeAStarNode(State(root_location, -1,
-                    get_direction(neighbor.location, root_state.location)), 0, 0, nullptr, 0);
-            root->open_handle = heap.push(root);  // add root to heap
-            nodes.insert(root);       // add root to hash_table (nodes)
+            std::cout << "Skipping " << roots.size() - max_num_of_tables <<
+                " heuristic tables that exceed the memory budget" << std::endl;
+            roots.resize(max_num_of_tables);
         }
     }
-    else
+
+    // each worker owns a distance engine, so the searches share nothing but the (read-only) graph
+    ThreadPool pool(min(num_of_threads, max((int)roots.size(), 1)));
+    std::vector<HeuristicTable> tables(roots.size());
+    std::vector<std::unique_ptr<DistanceEngine> > engines(pool.size());
+    std::vector<std::vector<int> > distances(pool.size());
+    pool.parallel_for((int)roots.size(), [&](int i, int worker)
     {
-        StateTimeAStarNode* root = new StateTimeAStarNode(root_state, 0, 0, nullptr, 0);
-        root->open_handle = heap.push(root);  // add root to heap
-        nodes.insert(root);       // add root to hash_table (nodes)
+        if (engines[worker] == nullptr)
+            engines[worker].reset(new DistanceEngine(*this));
+        compute_heuristics(roots[i], distances[worker], *engines[worker]);
+        tables[i] = HeuristicTable(distances[worker]);
+    });
+    for (size_t i = 0; i < roots.size(); i++)
+        heuristics.insert(roots[i], std::move(tables[i]));
+
+    double runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    precomputing_time += runtime;
+    std::cout << "Computed " << roots.size() << " heuristic tables with " << pool.size() << " threads ("
+        << runtime << " s)" << std::endl;
+}
+
+
+string BasicGraph::get_heuristic_name() const
+{
+    switch (heuristic)
+    {
+        case MANHATTAN: return "MANHATTAN";
+        case LANDMARK: return "LANDMARK";
+        default: return "SHORTEST_PATH";
     }
+}
+
+
+string BasicGraph::get_legacy_heuristics_table_name() const
+{
+    return map_name + (consider_rotation ? "_rotation" : "") + "_heuristics_table.txt";
+}
 
-	while (!heap.empty()) 
+
+string BasicGraph::get_snapshot_name() const
+{
+    // the heuristic tables in the snapshot depend on the heuristic and rotation settings
+    string fname = map_name;
+    if (consider_rotation)
+        fname += "_rotation";
+    switch (heuristic)
     {
-        StateTimeAStarNode* curr = heap.top();
-		heap.pop();
-		for (auto next_state : get_reverse_neighbors(curr->state))
-		{
-			double next_g_val = curr->g_val + get_weight(next_state.location, curr->state.location);
-            StateTimeAStarNode* next = new StateTimeAStarNode(next_state, next_g_val, 0, nullptr, 0);
-			auto it = nodes.find(next);
-			if (it == nodes.end()) 
-			{  // add the newly generated node to heap and hash table
-				next->open_handle = heap.push(next);
-				nodes.insert(next);
-			}
-			else 
-			{  // update existing node's g_val if needed (only in the heap)
-				delete(next);  // not needed anymore -- we already generated it before
-                StateTimeAStarNode* existing_next = *it;
-				if (existing_next->g_val > next_g_val) 
-				{
-					existing_next->g_val = next_g_val;
-					heap.increase(existing_next->open_handle);
-				}
-			}
-		}
-	}
-	// iterate over all nodes and populate the distances
-	for (auto it = nodes.begin(); it != nodes.end(); it++)
-	{
-        StateTimeAStarNode* s = *it;
-		res[s->state.location] = std::min(s->g_val, res[s->state.location]);
-		delete (s);
-	}
-	nodes.clear();
-	heap.clear();
-    return res;
+        case MANHATTAN: fname += "_manhattan"; break;
+        case LANDMARK: fname += "_landmark"; break;
+        default: fname += "_shortest_path"; break;
+    }
+    return fname + "_snapshot.bin";
 }
 
 
@@ -282,4 +745,9 @@ void BasicGraph::copy(const BasicGraph& copy)
     rows = copy.get_rows();
     cols = copy.get_cols();
     weights = copy.get_weights();
+    valid_moves = copy.valid_moves;
+    integer_weights = copy.integer_weights;
+    uniform_weights = copy.uniform_weights;
+    types = copy.types;
+    cell_types = copy.cell_types;
 }
\ No newline at end of file
@@ -1,8 +1,9 @@
 #include "BasicSystem.h"
 #include <stdlib.h>
 #include <boost/tokenizer.hpp>
+#include <chrono>
 
-BasicSystem::BasicSystem(BasicGraph& G, MAPFSolver& solver): G(G), solver(solver), num_of_tasks(0) {}
+BasicSystem::BasicSystem(BasicGraph& G, MAPFSolver& solver): G(G), solver(solver), num_of_tasks(0), prioritized_rt(G) {}
 
 BasicSystem::~BasicSystem() {}
 
@@ -412,7 +413,7 @@ list<tuple<int, int, int>> BasicSystem::move()
             }
 
             // Check whether this move has conflicts with other agents
-			if (G.types[curr.location] != "Magic")
+			if (!G.is_magic(curr.location))
 			{
 				for (int j = k + 1; j < num_of_drives; j++)
 				{
@@ -530,11 +531,50 @@ void BasicSystem::save_results()
     }
     output.close();
 
+    save_statistics();
+
     saving_time = (std::clock() - t) / CLOCKS_PER_SEC;
 	if (screen)
 		std::cout << "Done! (" << saving_time << " s)" << std::endl;
 }
 
+void BasicSystem::save_statistics() const
+{
+    std::ofstream output;
+    output.open(outfile + "/stats.txt", std::ios::out);
+    const SingleAgentSolver& planner = solver.path_planner;
+    output << "map_loading_time: " << G.map_loading_time << std::endl
+        << "map_file_bytes: " << G.map_file_size << std::endl
+        << "map_snapshot: " << G.loaded_from_snapshot << std::endl
+        << "map_loading_throughput_mb_per_s: "
+        << (G.map_loading_time > 0 ? G.map_file_size / G.map_loading_time / 1e6 : 0) << std::endl;
+    output << "heuristic: " << G.get_heuristic_name() << std::endl
+        << "heuristic_tables: " << G.heuristics.size() << std::endl
+        << "heuristic_landmarks: " << G.landmarks.size() << std::endl
+        << "heuristic_threads: " << G.num_of_threads << std::endl
+        << "heuristic_precomputing_time: " << G.precomputing_time << std::endl
+        << "heuristic_loading_time: " << G.heuristics_loading_time << std::endl
+        << "heuristic_memory_budget: " << G.heuristics.memory_budget << std::endl
+        << "heuristic_peak_memory: " << G.heuristics.peak_memory_usage << std::endl
+        << "heuristic_hits: " << G.heuristics.num_of_hits << std::endl
+        << "heuristic_misses: " << G.heuristics.num_of_misses << std::endl
+        << "heuristic_evictions: " << G.heuristics.num_of_evictions << std::endl;
+    const char* queue_names[] = {"FIBONACCI", "BUCKET", "HEAP"};
+    output << "low_level_solver: " << planner.getName() << std::endl
+        << "low_level_queue: " << queue_names[planner.get_queue_policy(G)] << std::endl
+        << "low_level_searches: " << planner.num_of_searches << std::endl
+        << "low_level_expanded: " << planner.accumulated_expanded << std::endl
+        << "low_level_generated: " << planner.accumulated_generated << std::endl
+        << "low_level_node_allocations: " << planner.accumulated_allocations << std::endl
+        << "low_level_runtime: " << planner.accumulated_runtime << std::endl
+        << "low_level_nodes_per_sec: " <<
+        (planner.accumulated_runtime > 0 ? planner.accumulated_generated / planner.accumulated_runtime : 0) << std::endl;
+    const ReservationTable& rt = solver.get_reservation_table();
+    output << "reservation_table: " << (rt.ct_mode == DENSE_TABLE ? "DENSE" : "HASHED") << std::endl
+        << "reservation_table_builds: " << rt.num_of_builds << std::endl
+        << "reservation_table_runtime: " << rt.accumulated_runtime << std::endl;
+    output.close();
+}
 
 void BasicSystem::update_travel_times(unordered_map<int, double>& travel_times)
 {
@@ -683,6 +723,7 @@ void BasicSystem::solve()
         }
         else
         {
+            auto start = std::chrono::steady_clock::now(); // the fallback shares the time limit of the solver
             bool sol = solver.run(starts, goal_locations, time_limit);
             if (sol)
             {
@@ -692,13 +733,21 @@ void BasicSystem::solve()
             }
             else
             {
-                if (solver.solution.empty())
+                vector<Path> planned_paths;
+                if (prioritized_fallback && solve_by_prioritized_planning(planned_paths, start))
                 {
-                std::cout << "solver.solution is empty" << std::endl;
-                return;
+                    update_paths(planned_paths);
+                }
+                else
+                {
+                    if (solver.solution.empty())
+                    {
+                        std::cout << "solver.solution is empty" << std::endl;
+                        return;
+                    }
+                    lra.resolve_conflicts(solver.solution);
+                    update_paths(lra.solution);
                 }
-                lra.resolve_conflicts(solver.solution);
-                update_paths(lra.solution);
             }
         }
         if (log)
@@ -709,10 +758,48 @@ void BasicSystem::solve()
                                     + std::to_string(num_of_drives) + "," + std::to_string(seed));
 }
 
+bool BasicSystem::solve_by_prioritized_planning(vector<Path>& planned_paths,
+	std::chrono::steady_clock::time_point start)
+{
+	ReservationTable& rt = prioritized_rt;
+	rt.ct_mode = solver.initial_rt.ct_mode;
+	rt.num_of_agents = num_of_drives;
+	rt.map_size = G.size();
+	rt.k_robust = k_robust;
+	rt.window = solver.window;
+	rt.hold_endpoints = hold_endpoints;
+	rt.use_cat = false;
+	rt.prioritize_start = false;
+	// the solver may have planned with prioritized start locations, which the sweep does not reserve
+	bool prioritize_start = solver.path_planner.prioritize_start;
+	solver.path_planner.prioritize_start = false;
+	PrioritizedPlanner planner(G, solver.path_planner, rt);
+	planner.init(solver.initial_rt, vector<Path>(num_of_drives), solver.initial_constraints);
+	planned_paths.resize(num_of_drives);
+	bool sol = true;
+	for (int i = 0; i < num_of_drives && sol; i++)
+	{
+		if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > time_limit)
+		{
+			sol = false;
+			break;
+		}
+		planned_paths[i] = planner.plan(i, starts[i], goal_locations[i]);
+		sol = !planned_paths[i].empty();
+	}
+	planner.clear();
+	solver.path_planner.prioritize_start = prioritize_start;
+	if (screen > 0)
+		std::cout << "Prioritized planning " << (sol ? "succeeded" : "failed") << std::endl;
+	return sol;
+}
+
+
 bool BasicSystem::solve_by_WHCA(vector<Path>& planned_paths,
 	const vector<State>& new_starts, const vector< vector<pair<int, int> > >& new_goal_locations)
 {
 	WHCAStar whca(G, solver.path_planner);
+    whca.set_constraint_table_mode(solver.initial_rt.ct_mode);
     whca.k_robust = k_robust;
     whca.window = INT_MAX;
     whca.hold_endpoints = hold_endpoints || useDummyPaths;
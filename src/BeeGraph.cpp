@@ -6,8 +6,8 @@ bool BeeGraph::load_map(string fname)
 {
 	using namespace boost;
 	// read parameters
-	std::ifstream myfile((fname).c_str());
-	if (!myfile.is_open())
+	MapParser parser;
+	if (!parser.open(fname))
 	{
 		std::cout << "Parameter file " << fname << " does not exist. " << std::endl;
 		return false;
@@ -16,80 +16,71 @@ bool BeeGraph::load_map(string fname)
 	std::size_t pos = fname.rfind('.');      // position of the file extension
 	map_name = fname.substr(0, pos);     // get the name without extension
 	string temp;
-	myfile >> temp >> this->rows; // size
-	this->cols = this->rows;
-	move[0] = 1;
-	move[1] = -cols;
-	move[2] = -1;
-	move[3] = cols;
-	int num_of_obstacles;
-	myfile >> temp >> num_of_obstacles; // removes
-	int num_of_flowers;
-	myfile >> temp >> num_of_flowers; // D
+	parser.read_word(); // size
+	int size = parser.read_int();
+	set_size(size, size);
+	parser.read_word(); // removes
+	int num_of_obstacles = parser.read_int();
+	parser.read_word(); // D
+	int num_of_flowers = parser.read_int();
 	flowers.resize(num_of_flowers);
 	flower_demands.resize(num_of_flowers);
 	flower_costs.resize(num_of_flowers);
 	flower_time_windows.resize(num_of_flowers);
-	myfile >> temp >> num_of_bees; // N
-	int num_of_initial_locations;
-	myfile >> temp >> num_of_initial_locations; // R
+	parser.read_word(); // N
+	num_of_bees = parser.read_int();
+	parser.read_word(); // R
+	int num_of_initial_locations = parser.read_int();
 	initial_locations.resize(num_of_initial_locations);
-	myfile >> temp >> max_timestep; // T
-	myfile >> temp >> bee_capacity; // Q
-	myfile >> temp; // demand
+	parser.read_word(); // T
+	max_timestep = parser.read_int();
+	parser.read_word(); // Q
+	bee_capacity = parser.read_int();
+	parser.read_word(); // demand
 	for (int i = 0; i < num_of_flowers; i++)
 	{
-		myfile >> flower_demands[i];
+		flower_demands[i] = parser.read_int();
 	}
-	myfile >> temp >> wait_cost; // theta_1
-	myfile >> temp >> move_cost; // theta_2
-	myfile >> temp; // theta_d
+	parser.read_word(); // theta_1
+	wait_cost = parser.read_int();
+	parser.read_word(); // theta_2
+	move_cost = parser.read_int();
+	parser.read_word(); // theta_d
 	for (int i = 0; i < num_of_flowers; i++)
 	{
-		myfile >> flower_costs[i];
+		flower_costs[i] = parser.read_int();
 	}
-	myfile >> temp; // D_locations
+	parser.read_word(); // D_locations
 	for (int i = 0; i < num_of_flowers; i++)
 	{
-		myfile >> flowers[i];
-		flowers[i]--;
+		flowers[i] = parser.read_int() - 1;
 	}
-	myfile >> temp >> this->entrance; // N_location
-	this->entrance--;
-	myfile >> temp; // R_locations
+	parser.read_word(); // N_location
+	this->entrance = parser.read_int() - 1;
+	parser.read_word(); // R_locations
 	for (int i = 0; i < num_of_initial_locations; i++)
 	{
-		myfile >> initial_locations[i];
-		initial_locations[i]--;
+		initial_locations[i] = parser.read_int() - 1;
 	}
-	myfile >> temp; // remove_locations
-	this->types.resize(rows * cols, "Travel");
-	int id;
+	parser.read_word(); // remove_locations
 	for (int i = 0; i < num_of_obstacles; i++)
 	{
-		myfile >> id;
-		types[id - 1] = "Obstacle";
+		cell_types[parser.read_int() - 1] = OBSTACLE;
 	}
-	types[entrance] = "Magic"; // vertex collsions at the Magic vertex are ignored!
+	cell_types[entrance] = MAGIC; // vertex collsions at the Magic vertex are ignored!
 
-	this->weights.resize(rows * cols);
 	for (int i = 0; i < cols * rows; i++)
 	{
-		weights[i].resize(5, WEIGHT_MAX);
-		if (types[i] == "Obstacle")
+		if (is_type(i, OBSTACLE))
 			continue;
-		else if (types[i] == "Magic")
+		else if (is_type(i, MAGIC))
 			weights[i][4] = wait_cost; //0; // waiting at the entrance has zero costs.
 		else
 			weights[i][4] = wait_cost; // wait actions are allowed
-		for (int dir = 0; dir < 4; dir++)
-		{
-			if (0 <= i + move[dir] && i + move[dir] < cols * rows && get_Manhattan_distance(i, i + move[dir]) <= 1 && types[i + move[dir]] != "Obstacle")
-				weights[i][dir] = move_cost;
-		}
 	}
+	connect_free_cells(move_cost);
 
-	myfile.close();
+	finish_loading(parser);
 
 	// read time windows
 	string windowfname;
@@ -122,76 +113,41 @@ bool BeeGraph::load_map(string fname)
 
 bool BeeGraph::load_Nathan_map(string fname)
 {
-	using namespace boost;
-	string line;
-	std::ifstream myfile((fname).c_str());
-	if (!myfile.is_open())
+	MapParser parser;
+	if (!parser.open(fname))
 	{
 		std::cout << "Map file " << fname << " does not exist. " << std::endl;
 		return false;
 	}
 
 	std::cout << "*** Loading map ***" << std::endl;
-	clock_t t = std::clock();
 	std::size_t pos = fname.rfind('.');      // position of the file extension
 	map_name = fname.substr(0, pos);     // get the name without extension
 
-	tokenizer< char_separator<char> >::iterator beg;
-	getline(myfile, line); // skip word "type:*"
-	char_separator<char> sep(" ");
-	getline(myfile, line);
-	tokenizer< char_separator<char> > tok(line, sep);
-	beg = tok.begin();
-	beg++;
-	this->rows = atoi((*beg).c_str()); // read number of rows
-	getline(myfile, line);
-	tokenizer< char_separator<char> > tok2(line, sep);
-	beg = tok2.begin();
-	beg++;
-	this->cols = atoi((*beg).c_str()); // read number of cols
-	move[0] = 1;
-	move[1] = -cols;
-	move[2] = -1;
-	move[3] = cols;
-	getline(myfile, line); // skip word "map"
+	parser.skip_line(); // skip word "type:*"
+	parser.skip_fields(1, ' ');
+	int rows = parser.read_int(' '); // read number of rows
+	parser.skip_line();
+	parser.skip_fields(1, ' ');
+	int cols = parser.read_int(' '); // read number of cols
+	parser.skip_line();
+	set_size(rows, cols);
+	parser.skip_line(); // skip word "map"
 
-	 //read tyeps and edge weights
-	this->types.resize(rows * cols);
-	this->weights.resize(rows * cols);
 	// read map (and start/goal locations)
 	for (int i = 0; i < rows; i++) {
-		getline(myfile, line);
+		MapToken line = parser.read_line();
 		for (int j = 0; j < cols; j++) {
 			int id = cols * i + j;
-			weights[id].resize(5, WEIGHT_MAX);
-			if (line[j] == '.')
-			{
-				this->types[id] = "Travel";
-			}
-			else
-			{
-				this->types[id] = "Obstacle";
-			}
+			if (j >= (int)line.length || line[j] != '.')
+				cell_types[id] = OBSTACLE;
 		}
 	}
+	connect_free_cells(1);
 
-	for (int i = 0; i < cols * rows; i++)
-	{
-		if (types[i] == "Obstacle")
-		{
-			continue;
-		}
-		for (int dir = 0; dir < 4; dir++)
-		{
-			if (0 <= i + move[dir] && i + move[dir] < cols * rows && get_Manhattan_distance(i, i + move[dir]) <= 1 && types[i + move[dir]] != "Obstacle")
-				weights[i][dir] = 1;
-		}
-	}
-	
-	myfile.close();
-	double runtime = (std::clock() - t) / CLOCKS_PER_SEC;
+	finish_loading(parser);
 	std::cout << "Map size: " << rows << "x" << cols << std::endl;
-	std::cout << "Done! (" << runtime << " s)" << std::endl;
+	std::cout << "Done! (" << map_loading_time << " s)" << std::endl;
 	return true;
 }
 
@@ -201,7 +157,7 @@ void BeeGraph::preprocessing(string fname, bool consider_rotation)
 	// std::cout << "*** PreProcessing map ***" << std::endl;
 	clock_t t = std::clock();
 	this->consider_rotation = consider_rotation;
-	heuristics[entrance] = compute_heuristics(entrance);
+	std::vector<int> roots(1, entrance);
 	std::ifstream myfile((fname).c_str());
 	if (myfile.is_open())
 	{
@@ -217,14 +173,12 @@ void BeeGraph::preprocessing(string fname, bool consider_rotation)
 			while (iss >> id)
 			{
 				id--;
-				if (heuristics.find(flowers[id]) == heuristics.end())
-				{
-					heuristics[flowers[id]] = compute_heuristics(flowers[id]);
-				}
+				roots.push_back(flowers[id]);
 			}
 		}
 	}
 	myfile.close();
+	precompute_heuristics(roots);
 
 	preprocessing_time = (std::clock() - t) * 1.0 / CLOCKS_PER_SEC;
 	// std::cout << heuristics.size() << " flowers!" << std::endl;
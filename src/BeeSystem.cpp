@@ -347,7 +347,7 @@ int BeeSystem::get_flowtime_lowerbound() const
 		for (auto task : finished_tasks[k])
 		{
 			if (task.second != 0)
-				rst += G.heuristics.at(task.first)[prev];
+				rst += G.get_heuristic(task.first)[prev];
 			prev = task.first;
 		}
 	}
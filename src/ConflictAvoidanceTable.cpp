@@ -0,0 +1,40 @@
+#include "ConflictAvoidanceTable.h"
+#include <limits>
+
+
+void ConflictAvoidanceTable::reset(size_t new_map_size, int new_num_of_timesteps)
+{
+    new_num_of_timesteps = max(new_num_of_timesteps, 0);
+    if (new_map_size != map_size || (size_t)new_num_of_timesteps > stride)
+    {
+        // reallocate only if the map changes or the window grows
+        map_size = new_map_size;
+        stride = max(stride, (size_t)new_num_of_timesteps);
+        counts.assign(map_size * stride, 0);
+        touched.clear();
+    }
+    else
+    {
+        for (size_t cell : touched)
+            counts[cell] = 0;
+        touched.clear();
+    }
+    num_of_timesteps = new_num_of_timesteps;
+}
+
+
+void ConflictAvoidanceTable::add(int location, int timestep, int delta)
+{
+    if (timestep < 0 || timestep >= num_of_timesteps)
+        return;
+    size_t cell = location * stride + timestep;
+    if (counts[cell] == 0)
+    {
+        if (delta <= 0)
+            return;
+        touched.push_back(cell);
+    }
+    else if (delta > 0 && counts[cell] == std::numeric_limits<uint16_t>::max())
+        return;
+    counts[cell] = (uint16_t)(counts[cell] + delta);
+}
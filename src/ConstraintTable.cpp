@@ -0,0 +1,186 @@
+#include "ConstraintTable.h"
+
+
+void ConstraintTable::configure(constraint_table_mode new_mode, size_t new_num_of_ids, int new_horizon)
+{
+    new_horizon = min(max(new_horizon, 0), 64);
+    if (new_mode != mode || (new_mode == DENSE_TABLE && new_num_of_ids != num_of_ids))
+    {
+        hashed.clear();
+        touched.clear();
+        num_of_occupied = 0;
+        mode = new_mode;
+        num_of_ids = new_num_of_ids;
+        horizon = new_horizon;
+        if (mode == DENSE_TABLE)
+        {
+            dense_ranges.assign(num_of_ids, TimeRanges());
+            dense_bits.assign(num_of_ids, 0);
+            is_touched.assign(num_of_ids, false);
+        }
+        else
+        {
+            dense_ranges = vector<TimeRanges>();
+            dense_bits = vector<uint64_t>();
+            is_touched = vector<bool>();
+        }
+        return;
+    }
+    num_of_ids = new_num_of_ids;
+    if (new_horizon == horizon)
+        return;
+    horizon = new_horizon;
+    for (int id : touched) // recompute the bits of the existing constraints
+        update_bits(id);
+}
+
+
+// the bits of the timesteps in [t_min, t_max) that are below the horizon
+static inline uint64_t range_bits(int t_min, int t_max, int horizon)
+{
+    int from = max(t_min, 0);
+    int to = min(t_max, horizon);
+    if (from >= to)
+        return 0;
+    uint64_t high = to == 64 ? ~(uint64_t)0 : ((uint64_t)1 << to) - 1;
+    return high & ~(((uint64_t)1 << from) - 1);
+}
+
+
+void ConstraintTable::update_bits(int id)
+{
+    dense_bits[id] = 0;
+    for (const auto& range : dense_ranges[id])
+        dense_bits[id] |= range_bits(range.t_min, range.t_max, horizon);
+}
+
+
+void ConstraintTable::insert(size_t id, int t_min, int t_max, int owner)
+{
+    if (!is_dense(id))
+    {
+        hashed[id].push_back({t_min, t_max, owner});
+        return;
+    }
+    if (!is_touched[id])
+    {
+        touched.push_back((int)id);
+        is_touched[id] = true;
+    }
+    if (dense_ranges[id].empty())
+        num_of_occupied++;
+    dense_ranges[id].push_back({t_min, t_max, owner});
+    dense_bits[id] |= range_bits(t_min, t_max, horizon);
+}
+
+
+void ConstraintTable::remove(size_t id, int owner, TimeRanges* removed)
+{
+    TimeRanges* ranges;
+    unordered_map<size_t, TimeRanges>::iterator it;
+    if (is_dense(id))
+    {
+        ranges = &dense_ranges[id];
+    }
+    else
+    {
+        it = hashed.find(id);
+        if (it == hashed.end())
+            return;
+        ranges = &it->second;
+    }
+    size_t kept = 0;
+    for (const auto& range : *ranges)
+    {
+        if (range.owner != owner)
+            (*ranges)[kept++] = range;
+        else if (removed != nullptr)
+            removed->push_back(range);
+    }
+    if (kept == ranges->size())
+        return;
+    ranges->resize(kept);
+    if (is_dense(id))
+    {
+        update_bits((int)id);
+        if (ranges->empty())
+            num_of_occupied--;
+    }
+    else if (ranges->empty())
+        hashed.erase(it);
+}
+
+
+const TimeRanges* ConstraintTable::find(size_t id) const
+{
+    if (is_dense(id))
+        return dense_ranges[id].empty() ? nullptr : &dense_ranges[id];
+    auto it = hashed.find(id);
+    return it == hashed.end() ? nullptr : &it->second;
+}
+
+
+bool ConstraintTable::is_constrained(size_t id, int timestep) const
+{
+    if (is_dense(id) && 0 <= timestep && timestep < horizon)
+        return (dense_bits[id] >> timestep) & 1;
+    const TimeRanges* ranges = find(id);
+    if (ranges == nullptr)
+        return false;
+    for (const auto& range : *ranges)
+    {
+        if (range.t_min <= timestep && timestep < range.t_max)
+            return true;
+    }
+    return false;
+}
+
+
+int ConstraintTable::get_holding_time(size_t id) const
+{
+    const TimeRanges* ranges = find(id);
+    if (ranges == nullptr)
+        return 0;
+    int t = 0;
+    for (const auto& range : *ranges)
+        t = max(t, range.t_max);
+    return t;
+}
+
+
+void ConstraintTable::clear()
+{
+    hashed.clear();
+    for (int id : touched)
+    {
+        dense_ranges[id].clear(); // keep the capacity
+        dense_bits[id] = 0;
+        is_touched[id] = false;
+    }
+    touched.clear();
+    num_of_occupied = 0;
+}
+
+
+void ConstraintTable::copy(const ConstraintTable& other)
+{
+    clear();
+    if (mode == other.mode && num_of_ids == other.num_of_ids && horizon == other.horizon)
+    {
+        hashed = other.hashed;
+        for (int id : other.touched)
+        {
+            dense_ranges[id] = other.dense_ranges[id];
+            dense_bits[id] = other.dense_bits[id];
+            is_touched[id] = true;
+        }
+        touched = other.touched;
+        num_of_occupied = other.num_of_occupied;
+        return;
+    }
+    other.for_each([this](size_t id, const TimeRanges& ranges)
+    {
+        for (const auto& range : ranges)
+            insert(id, range.t_min, range.t_max, range.owner);
+    });
+}
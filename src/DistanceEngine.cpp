@@ -0,0 +1,176 @@
+#include "DistanceEngine.h"
+#include <cmath>
+#include <queue>
+#include <functional>
+
+#define MAX_NUM_OF_BUCKETS 1024
+
+
+DistanceEngine::DistanceEngine(const BasicGraph& G): G(G), consider_rotation(G.consider_rotation)
+{
+    num_of_states = consider_rotation ? 4 * G.size() : G.size();
+
+    // pick the search method according to the edge weights
+    bool unit_weights = true;
+    bool integer_weights = true;
+    double max_w = 0;
+    int num_of_weights = consider_rotation ? 5 : 4; // wait weights are only used for turning
+    for (int loc = 0; loc < G.size(); loc++)
+    {
+        for (int i = 0; i < num_of_weights; i++)
+        {
+            double w = G.weights[loc][i];
+            if (w >= WEIGHT_MAX - 1)
+                continue;
+            if (w != 1)
+                unit_weights = false;
+            if (w < 0 || w != std::floor(w))
+                integer_weights = false;
+            max_w = max(max_w, w);
+        }
+    }
+    max_weight = (int)max_w;
+    if (unit_weights)
+        method = BFS;
+    else if (integer_weights && max_weight < MAX_NUM_OF_BUCKETS)
+        method = DIAL;
+    else
+        method = DIJKSTRA;
+}
+
+
+string DistanceEngine::get_method_name() const
+{
+    switch (method)
+    {
+        case BFS: return "BFS";
+        case DIAL: return "Dial";
+        default: return "Dijkstra";
+    }
+}
+
+
+void DistanceEngine::compute(int root_location, vector<int>& distances)
+{
+    state_distances.assign(num_of_states, INT_MAX);
+    queue.clear();
+    if (consider_rotation)
+    {
+        for (int orientation = 0; orientation < 4; orientation++)
+        {
+            state_distances[root_location * 4 + orientation] = 0;
+            queue.push_back(root_location * 4 + orientation);
+        }
+    }
+    else
+    {
+        state_distances[root_location] = 0;
+        queue.push_back(root_location);
+    }
+
+    switch (method)
+    {
+        case BFS: bfs(); break;
+        case DIAL: dial(); break;
+        default: dijkstra(); break;
+    }
+
+    if (!consider_rotation)
+    {
+        distances.swap(state_distances);
+        return;
+    }
+    distances.assign(G.size(), INT_MAX);
+    for (int state = 0; state < num_of_states; state++)
+    {
+        if (state_distances[state] < distances[state >> 2])
+            distances[state >> 2] = state_distances[state];
+    }
+}
+
+
+// the roots are in queue
+void DistanceEngine::bfs()
+{
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int curr = queue[head];
+        int next_distance = state_distances[curr] + 1;
+        for_each_predecessor(curr, [&](int prev, double)
+        {
+            if (state_distances[prev] == INT_MAX)
+            {
+                state_distances[prev] = next_distance;
+                queue.push_back(prev);
+            }
+        });
+    }
+}
+
+
+// Dijkstra with a circular array of max_weight + 1 buckets, one per distance value
+void DistanceEngine::dial()
+{
+    int num_of_buckets = max_weight + 1;
+    buckets.resize(num_of_buckets);
+    for (auto& bucket : buckets)
+        bucket.clear();
+    buckets[0].swap(queue);
+    size_t num_of_pending = buckets[0].size();
+    for (int distance = 0; num_of_pending > 0; distance++)
+    {
+        auto& bucket = buckets[distance % num_of_buckets];
+        for (size_t i = 0; i < bucket.size(); i++) // the bucket can grow through zero-weight edges
+        {
+            int curr = bucket[i];
+            num_of_pending--;
+            if (state_distances[curr] != distance) // outdated entry
+                continue;
+            for_each_predecessor(curr, [&](int prev, double weight)
+            {
+                int next_distance = distance + (int)weight;
+                if (next_distance < state_distances[prev])
+                {
+                    state_distances[prev] = next_distance;
+                    buckets[next_distance % num_of_buckets].push_back(prev);
+                    num_of_pending++;
+                }
+            });
+        }
+        bucket.clear();
+    }
+}
+
+
+void DistanceEngine::dijkstra()
+{
+    typedef pair<double, int> Entry; // <distance, state>
+    std::priority_queue<Entry, vector<Entry>, std::greater<Entry> > heap;
+    vector<double> distances(num_of_states, DBL_MAX);
+    for (int root : queue)
+    {
+        distances[root] = 0;
+        heap.emplace(0, root);
+    }
+    while (!heap.empty())
+    {
+        Entry curr = heap.top();
+        heap.pop();
+        if (curr.first > distances[curr.second]) // outdated entry
+            continue;
+        for_each_predecessor(curr.second, [&](int prev, double weight)
+        {
+            double next_distance = curr.first + weight;
+            if (next_distance < distances[prev])
+            {
+                distances[prev] = next_distance;
+                heap.emplace(next_distance, prev);
+            }
+        });
+    }
+    for (int state = 0; state < num_of_states; state++)
+    {
+        if (distances[state] < INT_MAX)
+            state_distances[state] = (int)std::floor(distances[state]);
+    }
+}
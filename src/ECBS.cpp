@@ -278,12 +278,9 @@ void ECBS::choose_conflict(ECBSNode &node) const
 }*/
 
 
-bool ECBS::find_path(ECBSNode* node, int agent)
+// extract all constraints on the agent
+void ECBS::collect_constraints(ECBSNode* node, int agent, list<Constraint>& constraints) const
 {
-    Path path;
-
-    // extract all constraints on the agent
-    list<Constraint> constraints;
     ECBSNode* curr = node;
     while (curr != dummy_start)
     {
@@ -312,14 +309,28 @@ bool ECBS::find_path(ECBSNode* node, int agent)
         }
         curr = curr->parent;
     }
-	rt.copy(initial_rt);
+}
+
+
+bool ECBS::find_path(ECBSNode* node, int agent)
+{
+    list<Constraint> constraints;
+    collect_constraints(node, agent, constraints);
+	rt.setBase(initial_rt);
     rt.build(paths, initial_constraints, constraints, agent);
 
-    path = path_planner.run(G, starts[agent], goal_locations[agent], rt);
+    Path path = path_planner.run(G, starts[agent], goal_locations[agent], rt);
     rt.clear();
     LL_num_expanded += path_planner.num_expanded;
     LL_num_generated += path_planner.num_generated;
+    return replace_path(node, agent, constraints, path, path_planner.min_f_val, path_planner.path_cost);
+}
+
 
+// replace the path of the agent in the node by the new path (empty if none was found)
+bool ECBS::replace_path(ECBSNode* node, int agent, const list<Constraint>& constraints,
+                        Path& path, double min_f_val, double path_cost)
+{
     if (path.empty())
     {
         if (screen == 2)
@@ -332,14 +343,14 @@ bool ECBS::find_path(ECBSNode* node, int agent)
         cout << path << endl;
         for (auto constraint : constraints)
             cout << constraint << endl;
-		rt.copy(initial_rt);
+		rt.setBase(initial_rt);
         rt.build(paths, list< tuple<int, int, int> >(), constraints, agent);
         path = path_planner.run(G, starts[agent], goal_locations[agent], rt);
         rt.clear();
         exit(-1);
     }
-    node->g_val = node->g_val - path_costs[agent] + path_planner.path_cost;
-    node->min_f_val = node->min_f_val - path_min_costs[agent] + path_planner.min_f_val;
+    node->g_val = node->g_val - path_costs[agent] + path_cost;
+    node->min_f_val = node->min_f_val - path_min_costs[agent] + min_f_val;
     for (auto it = node->paths.begin(); it != node->paths.end(); ++it)
     {
         if (std::get<0>(*it) == agent)
@@ -348,12 +359,88 @@ bool ECBS::find_path(ECBSNode* node, int agent)
             break;
         }
     }
-    node->paths.emplace_back(agent, path, path_planner.min_f_val, path_planner.path_cost);
+    node->paths.emplace_back(agent, path, min_f_val, path_cost);
     paths[agent] = &std::get<1>(node->paths.back());
     return true;
 }
 
 
+// The children of a split on a negative constraint each replan a single agent against the paths of the parent,
+// so their searches are independent. Run them concurrently.
+// Their tables differ only by the constraints, the initial constraints and the path of the two agents.
+// So everything else goes into one finalized table, which both searches share as their base layer.
+// Return false (and plan nothing) if the split does not qualify.
+bool ECBS::find_paths_concurrently(ECBSNode* children[2], list<Constraint> constraints[2],
+                                   vector<PlannerPool::Query>& queries)
+{
+    if (planner_pool == nullptr)
+        return false;
+    int agents[2];
+    for (int i = 0; i < 2; i++)
+    {
+        if (std::get<4>(children[i]->constraints.front()))
+            return false;
+        agents[i] = std::get<0>(children[i]->constraints.front());
+    }
+    if (agents[0] == agents[1])
+        return false;
+    // The soft constraints of each child cover the timesteps of the longest other path (up to the window).
+    // They can only be split into layers if the shared ones cover as many.
+    int cat_size = 0;
+    for (int i = 0; i < num_of_agents; i++)
+    {
+        if (i != agents[0] && i != agents[1])
+            cat_size = max(cat_size, min((int)paths[i]->size(), window));
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (min((int)paths[agents[i]]->size(), window) > cat_size)
+            return false;
+    }
+
+    list< tuple<int, int, int> > shared_initial_constraints, own_initial_constraints[2];
+    for (const auto& con : initial_constraints)
+    {
+        if (std::get<0>(con) == agents[0])
+            own_initial_constraints[1].push_back(con);
+        else if (std::get<0>(con) == agents[1])
+            own_initial_constraints[0].push_back(con);
+        else
+            shared_initial_constraints.push_back(con);
+    }
+    vector<Path*> shared_paths(paths);
+    shared_paths[agents[0]] = nullptr;
+    shared_paths[agents[1]] = nullptr;
+    split_rt.copySettings(rt);
+    split_rt.setBase(initial_rt);
+    split_rt.build(shared_paths, shared_initial_constraints, list<Constraint>(), agents[0]);
+    split_rt.finalize();
+
+    child_rt.copySettings(rt);
+    ReservationTable* tables[2] = {&rt, &child_rt};
+    for (int i = 0; i < 2; i++)
+    {
+        collect_constraints(children[i], agents[i], constraints[i]);
+        vector<Path*> own_paths(num_of_agents, nullptr);
+        own_paths[agents[1 - i]] = paths[agents[1 - i]];
+        tables[i]->setBase(split_rt);
+        tables[i]->build(own_paths, own_initial_constraints[i], constraints[i], agents[i]);
+        queries.emplace_back(starts[agents[i]], goal_locations[agents[i]], *tables[i]);
+    }
+    planner_pool->run(queries);
+    for (int i = 0; i < 2; i++)
+    {
+        tables[i]->clear();
+        LL_num_expanded += queries[i].num_expanded;
+        LL_num_generated += queries[i].num_generated;
+    }
+    split_rt.clear();
+    rt.mergeStatistics(child_rt);
+    rt.mergeStatistics(split_rt);
+    return true;
+}
+
+
 bool ECBS::validate_path(const Path& path, const list<Constraint>& constraints) const
 {
     int a, v1, v2, t;
@@ -415,6 +502,13 @@ bool ECBS::generate_child(ECBSNode* node, ECBSNode* parent)
         if (!find_path(node, a))
             return false;
     }
+    finish_child(node, to_replan);
+    return true;
+}
+
+
+void ECBS::finish_child(ECBSNode* node, const list<int>& to_replan)
+{
     find_conflicts(node->parent->conflicts, node->conflicts, to_replan);
 	node->window = window;
     node->num_of_collisions = node->conflicts.size();
@@ -422,14 +516,12 @@ bool ECBS::generate_child(ECBSNode* node, ECBSNode* parent)
     // Estimate h value
     node->h_val = 0;
     node->f_val = node->g_val + node->h_val;
-
-    return true;
 }
 
 
 bool ECBS::generate_root_node()
 {
-    clock_t time = std::clock();
+    auto time = std::chrono::steady_clock::now();
     dummy_start = new ECBSNode();
 
     // initialize paths_found_initially
@@ -443,7 +535,7 @@ bool ECBS::generate_root_node()
 
     for (int i = 0; i < num_of_agents; i++)
     {
-		rt.copy(initial_rt);
+		rt.setBase(initial_rt);
         rt.build(paths, initial_constraints, list<Constraint>(), i);
         Path path = path_planner.run(G, starts[i], goal_locations[i], rt);
         /*if (path.empty() && hold_endpoints && goal_locations[i].size() == 1)
@@ -480,7 +572,7 @@ bool ECBS::generate_root_node()
     best_node = dummy_start;
     if (screen == 2)
     {
-        runtime = (std::clock() - time) * 1.0 / CLOCKS_PER_SEC;
+        runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - time).count();
         std::cout << "Done! (" << runtime << "s)" << std::endl;
     }
     return true;
@@ -519,8 +611,8 @@ bool ECBS::run(const std::vector<State>& starts,
 {
     clear();
 
-    // set timer
-    start = std::clock();
+    // set timer (wall time, since the low-level searches may run on several threads)
+    start = std::chrono::steady_clock::now();
 
     this->starts = starts;
     this->goal_locations = goal_locations;
@@ -541,7 +633,9 @@ bool ECBS::run(const std::vector<State>& starts,
     path_planner.prioritize_start = false;
 	path_planner.hold_endpoints = hold_endpoints;
     rt.prioritize_start = false;
-    path_planner.travel_times.clear();
+    path_planner.travel_times = nullptr;
+    if (planner_threads > 1 && (planner_pool == nullptr || planner_pool->size() != planner_threads))
+        planner_pool.reset(new PlannerPool(G, path_planner, planner_threads));
 
     if (!generate_root_node())
         return false;
@@ -549,7 +643,7 @@ bool ECBS::run(const std::vector<State>& starts,
     // start the loop
     while (!open_list.empty() && !solution_found)
     {
-        runtime = (std::clock() - start) * 1.0  / CLOCKS_PER_SEC;
+        runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
         if (runtime > time_limit)
         {  // timeout
             solution_cost = -1;
@@ -637,9 +731,22 @@ bool ECBS::run(const std::vector<State>& starts,
         resolve_conflict(*curr->conflict, n[0], n[1]);
 
         vector<Path*> copy(paths);
+        list<Constraint> constraints[2];
+        vector<PlannerPool::Query> queries;
+        bool concurrent = find_paths_concurrently(n, constraints, queries);
         for (int i = 0; i < 2; i++)
         {
-            bool sol = generate_child(n[i], curr);
+            bool sol;
+            if (concurrent)
+            {
+                int agent = std::get<0>(n[i]->constraints.front());
+                sol = replace_path(n[i], agent, constraints[i], queries[i].path,
+                                  queries[i].min_f_val, queries[i].path_cost);
+                if (sol)
+                    finish_child(n[i], list<int>(1, agent));
+            }
+            else
+                sol = generate_child(n[i], curr);
             if (sol)
             {
                 HL_num_generated++;
@@ -666,7 +773,7 @@ bool ECBS::run(const std::vector<State>& starts,
     }  // end of while loop
 
 
-    runtime = (std::clock() - start) * 1.0 / CLOCKS_PER_SEC;
+    runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     get_solution();
     if (solution_found && !validate_solution())
     {
@@ -727,7 +834,7 @@ void ECBS::resolve_conflict(const Conflict& conflict, ECBSNode* n1, ECBSNode* n2
 
 
 ECBS::ECBS(BasicGraph& G, SingleAgentSolver& path_planner):
-        MAPFSolver(G, path_planner), disjoint_splitting(false) {}
+        MAPFSolver(G, path_planner), disjoint_splitting(false), child_rt(G), split_rt(G) {}
 
 
 void ECBS::release_closed_list()
@@ -0,0 +1,99 @@
+#include "HeuristicStore.h"
+#include <algorithm>
+
+
+HeuristicTable::HeuristicTable(const vector<int>& distances): num_of_values(distances.size())
+{
+    int max_distance = 0;
+    for (int h : distances)
+    {
+        if (h != INT_MAX && h > max_distance)
+            max_distance = h;
+    }
+    if (max_distance < UINT16_MAX)
+    {
+        compact.resize(distances.size());
+        for (size_t i = 0; i < distances.size(); i++)
+            compact[i] = distances[i] == INT_MAX ? UINT16_MAX : (uint16_t)distances[i];
+        values16 = compact.data();
+    }
+    else
+    {
+        wide = distances;
+        values32 = wide.data();
+    }
+}
+
+
+void HeuristicTable::copy_to(vector<int>& distances) const
+{
+    distances.resize(num_of_values);
+    if (values16 == nullptr)
+    {
+        std::copy(values32, values32 + num_of_values, distances.begin());
+        return;
+    }
+    for (size_t i = 0; i < num_of_values; i++)
+        distances[i] = values16[i] == UINT16_MAX ? INT_MAX : values16[i];
+}
+
+
+const HeuristicTable* HeuristicStore::find(int root_location)
+{
+    auto it = tables.find(root_location);
+    if (it == tables.end())
+    {
+        num_of_misses++;
+        return nullptr;
+    }
+    num_of_hits++;
+    if (memory_budget > 0 && it->second.table.is_owned() && it->second.lru_position != lru.begin())
+        lru.splice(lru.begin(), lru, it->second.lru_position); // mark as the most recently used
+    return &it->second.table;
+}
+
+
+const HeuristicTable& HeuristicStore::insert(int root_location, HeuristicTable&& table)
+{
+    auto it = tables.find(root_location);
+    if (it != tables.end())
+        erase(it);
+    Entry& entry = tables[root_location];
+    entry.table = std::move(table);
+    if (entry.table.is_owned())
+    {
+        lru.push_front(root_location);
+        entry.lru_position = lru.begin();
+        owned_memory += entry.table.memory_usage();
+        // never evict the new table, so that the caller can use it
+        while (memory_budget > 0 && owned_memory > memory_budget && lru.size() > 1)
+        {
+            erase(tables.find(lru.back()));
+            num_of_evictions++;
+        }
+        peak_memory_usage = max(peak_memory_usage, owned_memory);
+    }
+    return entry.table;
+}
+
+
+vector<int> HeuristicStore::get_root_locations() const
+{
+    vector<int> roots;
+    roots.reserve(tables.size());
+    for (const auto& entry : tables)
+        roots.push_back(entry.first);
+    std::sort(roots.begin(), roots.end());
+    return roots;
+}
+
+
+void HeuristicStore::erase(unordered_map<int, Entry>::iterator it)
+{
+    if (it->second.table.is_owned())
+    {
+        owned_memory -= it->second.table.memory_usage();
+        lru.erase(it->second.lru_position);
+    }
+    tables.erase(it);
+}
@@ -176,7 +176,7 @@ void KivaSystem::update_goal_locations()
 				{
 					// assign a new task
 					pair<int, int> next;
-					if (G.types[goal.first] == "Endpoint")
+					if (G.is_type(goal.first, ENDPOINT))
 					{
 						do
 						{
@@ -0,0 +1,76 @@
+#include "LandmarkHeuristic.h"
+#include "BasicGraph.h"
+#include "DistanceEngine.h"
+#include <cmath>
+
+
+void LandmarkHeuristic::build(const BasicGraph& G, int num_of_landmarks)
+{
+    landmarks.clear();
+    distances.clear();
+
+    bool integer_weights = true;
+    double max_turn_weight = 0;
+    double min_move_weight = DBL_MAX;
+    for (int loc = 0; loc < G.size(); loc++)
+    {
+        for (int i = 0; i < 5; i++)
+        {
+            double w = G.weights[loc][i];
+            if (w >= WEIGHT_MAX - 1)
+                continue;
+            if (w != std::floor(w))
+                integer_weights = false;
+            if (i == 4)
+                max_turn_weight = max(max_turn_weight, w);
+            else
+                min_move_weight = min(min_move_weight, w);
+        }
+    }
+    manhattan_weight = min_move_weight == DBL_MAX ? 0 : (int)std::floor(min_move_weight);
+    cols = G.get_cols();
+    slack = (G.consider_rotation ? (int)std::ceil(2 * max_turn_weight) : 0) + (integer_weights ? 0 : 1);
+
+    int first = -1;
+    for (int loc = 0; loc < G.size() && first < 0; loc++)
+    {
+        if (!G.is_type(loc, OBSTACLE))
+            first = loc;
+    }
+    if (first < 0 || num_of_landmarks <= 0)
+        return;
+
+    // min_distances[loc] is the distance from loc to its closest landmark so far
+    DistanceEngine engine(G);
+    vector<int> min_distances;
+    engine.compute(first, min_distances); // the first landmark is the location farthest from an arbitrary one
+    vector<vector<int> > tables;
+    vector<int> table;
+    while ((int)landmarks.size() < num_of_landmarks)
+    {
+        int landmark = -1;
+        for (int loc = 0; loc < G.size(); loc++)
+        {
+            // locations that cannot reach any landmark yet (e.g., in another component) come first
+            if (!G.is_type(loc, OBSTACLE) && min_distances[loc] > 0 &&
+                (landmark < 0 || min_distances[loc] > min_distances[landmark]))
+                landmark = loc;
+        }
+        if (landmark < 0) // every location is a landmark already
+            break;
+        engine.compute(landmark, table);
+        if (landmarks.empty())
+            min_distances = table;
+        for (int loc = 0; loc < G.size(); loc++)
+            min_distances[loc] = min(min_distances[loc], table[loc]);
+        landmarks.push_back(landmark);
+        tables.push_back(table);
+    }
+
+    distances.resize((size_t)G.size() * landmarks.size());
+    for (size_t i = 0; i < landmarks.size(); i++)
+    {
+        for (int loc = 0; loc < G.size(); loc++)
+            distances[(size_t)loc * landmarks.size() + i] = tables[i][loc];
+    }
+}
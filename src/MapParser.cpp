@@ -0,0 +1,99 @@
+#include "MapParser.h"
+#include <cstdlib>
+#include <cctype>
+
+
+bool MapParser::open(const string& fname)
+{
+    start = std::chrono::steady_clock::now();
+    if (!file.open(fname))
+        return false;
+    pos = file.data();
+    end = pos + file.size();
+    return true;
+}
+
+
+double MapParser::get_runtime() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+MapToken MapParser::read_line()
+{
+    MapToken token;
+    token.begin = pos;
+    while (pos < end && *pos != '\n')
+        pos++;
+    token.length = pos - token.begin;
+    if (token.length > 0 && token.begin[token.length - 1] == '\r')
+        token.length--;
+    if (pos < end)
+        pos++; // skip '\n'
+    return token;
+}
+
+
+MapToken MapParser::read_field(char sep)
+{
+    // skip the separators before the field, as boost::tokenizer does
+    while (!eol() && (*pos == sep || (sep == ' ' && *pos == '\t')))
+        pos++;
+    MapToken token;
+    token.begin = pos;
+    while (!eol() && *pos != sep && !(sep == ' ' && *pos == '\t'))
+        pos++;
+    token.length = pos - token.begin;
+    if (!eol())
+        pos++; // skip the separator
+    return token;
+}
+
+
+void MapParser::skip_fields(int num_of_fields, char sep)
+{
+    for (int i = 0; i < num_of_fields; i++)
+        read_field(sep);
+}
+
+
+MapToken MapParser::read_word()
+{
+    while (pos < end && isspace((unsigned char)*pos))
+        pos++;
+    MapToken token;
+    token.begin = pos;
+    while (pos < end && !isspace((unsigned char)*pos))
+        pos++;
+    token.length = pos - token.begin;
+    return token;
+}
+
+
+int MapParser::to_int(const MapToken& token)
+{
+    size_t i = 0;
+    bool negative = false;
+    if (i < token.length && (token[i] == '-' || token[i] == '+'))
+    {
+        negative = token[i] == '-';
+        i++;
+    }
+    int value = 0;
+    for (; i < token.length && '0' <= token[i] && token[i] <= '9'; i++)
+        value = value * 10 + (token[i] - '0');
+    return negative ? -value : value;
+}
+
+
+double MapParser::to_double(const MapToken& token)
+{
+    if (token == "inf")
+        return DBL_MAX;
+    char buffer[64]; // the mapped file is not null-terminated, so copy the field before calling strtod
+    size_t length = min(token.length, sizeof(buffer) - 1);
+    memcpy(buffer, token.begin, length);
+    buffer[length] = '\0';
+    return strtod(buffer, nullptr);
+}
@@ -0,0 +1,58 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+
+bool MappedFile::open(const string& fname)
+{
+    close();
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping stays valid after closing the descriptor
+    if (addr == MAP_FAILED)
+        return false;
+    bytes = static_cast<const char*>(addr);
+    num_of_bytes = (size_t)st.st_size;
+    return true;
+}
+
+
+void MappedFile::close()
+{
+    if (bytes != nullptr)
+        munmap(const_cast<char*>(bytes), num_of_bytes);
+    bytes = nullptr;
+    num_of_bytes = 0;
+}
+
+
+uint64_t MappedFile::get_content_hash() const
+{
+    // FNV-1a over 64-bit words, then over the remaining bytes
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= num_of_bytes; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    }
+    for (; i < num_of_bytes; i++)
+    {
+        hash ^= (uint64_t)(unsigned char)bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
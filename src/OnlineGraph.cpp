@@ -1,73 +1,43 @@
 #include "OnlineGraph.h"
 #include <fstream>
-#include <boost/tokenizer.hpp>
 #include "StateTimeAStar.h"
-#include <sstream>
 #include <random>
 #include <chrono>
 
 bool OnlineGrid::load_map(std::string fname)
 {
-	std::string line;
-	std::ifstream myfile((fname).c_str());
-	if (!myfile.is_open())
+	if (load_snapshot(fname))
+		return true;
+	MapParser parser;
+	if (!parser.open(fname))
 	{
 		std::cout << "Map file " << fname << " does not exist. " << std::endl;
 		return false;
 	}
 
 	std::cout << "*** Loading map ***" << std::endl;
-	clock_t t = std::clock();
 	std::size_t pos = fname.rfind('.');      // position of the file extension
 	map_name = fname.substr(0, pos);     // get the name without extension
-	getline(myfile, line); // skip the words "grid size"
-	getline(myfile, line);
-	boost::char_separator<char> sep(",");
-	boost::tokenizer< boost::char_separator<char> > tok(line, sep);
-	boost::tokenizer< boost::char_separator<char> >::iterator beg = tok.begin();
-	this->rows = atoi((*beg).c_str()); // read number of cols
-	beg++;
-	this->cols = atoi((*beg).c_str()); // read number of rows
-	move[0] = 1;
-	move[1] = -cols;
-	move[2] = -1;
-	move[3] = cols;
-
-	getline(myfile, line); // skip the headers
+	parser.skip_line(); // skip the words "grid size"
+	int rows = parser.read_int(','); // read number of rows
+	int cols = parser.read_int(','); // read number of cols
+	parser.skip_line();
+	set_size(rows, cols);
+	parser.skip_line(); // skip the headers
 
 	 //read tyeps and edge weights
-	this->types.resize(rows * cols);
-	this->weights.resize(rows * cols);
-	for (int i = 0; i < rows * cols; i++)
+	read_weighted_grid(parser, false, [&](int loc, cell_type type, const MapToken&)
 	{
-		getline(myfile, line);
-		boost::tokenizer< boost::char_separator<char> > tok(line, sep);
-		beg = tok.begin();
-		beg++; // skip id
-		this->types[i] = std::string(beg->c_str()); // read type
-		beg++;
-		if (types[i] == "Entry")
-			this->entries.push_back(i);
-		else if (types[i] == "Exit")
-			this->exits.push_back(i);
-		beg++; // skip x
-		beg++; // skip y
-		weights[i].resize(5);
-		for (int j = 0; j < 5; j++) // read edge weights
-		{
-			if (std::string(beg->c_str()) == "inf")
-				weights[i][j] = WEIGHT_MAX;
-			else
-				weights[i][j] = std::stod(beg->c_str());
-			beg++;
-		}
-	}
+		if (type == ENTRY)
+			this->entries.push_back(loc);
+		else if (type == EXIT)
+			this->exits.push_back(loc);
+	});
 
-	myfile.close();
-	double runtime = (std::clock() - t) / CLOCKS_PER_SEC;
+	finish_loading(parser);
 	std::cout << "Map size: " << rows << "x" << cols << " with " << entries.size() << " entry locations and " <<
 		exits.size() << " exit locations." << std::endl;
-	std::cout << "Done! (" << runtime << " s)" << std::endl;
+	std::cout << "Done! (" << map_loading_time << " s)" << std::endl;
 	return true;
 }
 
@@ -76,27 +46,32 @@ void OnlineGrid::preprocessing(bool consider_rotation)
 	std::cout << "*** PreProcessing map ***" << std::endl;
 	clock_t t = std::clock();
 	this->consider_rotation = consider_rotation;
-	std::string fname;
-	if (consider_rotation)
-		fname = map_name + "_rotation_heuristics_table.txt";
-	else
-		fname = map_name + "_heuristics_table.txt";
-	std::ifstream myfile(fname.c_str());
-	bool succ = false;
-	if (myfile.is_open())
-	{
-		succ = load_heuristics_table(myfile);
-		myfile.close();
-	}
+	bool succ = load_heuristics_table();
 	if (!succ)
 	{
-		for (auto exit : exits)
-		{
-			heuristics[exit] = compute_heuristics(exit);
-		}
-		save_heuristics_table(fname);
+		precompute_heuristics(exits);
 	}
+	save_snapshot();
 
 	double runtime = (std::clock() - t) / CLOCKS_PER_SEC;
 	std::cout << "Done! (" << runtime << " s)" << std::endl;
 }
+
+
+void OnlineGrid::save_locations(SnapshotWriter& writer) const
+{
+	writer.write_ints(entries);
+	writer.write_ints(exits);
+}
+
+
+bool OnlineGrid::load_locations(SnapshotReader& reader)
+{
+	auto new_entries = reader.read_ints();
+	auto new_exits = reader.read_ints();
+	if (reader.failed())
+		return false;
+	entries.swap(new_entries);
+	exits.swap(new_exits);
+	return true;
+}
@@ -25,7 +25,7 @@ void OnlineSystem::update_start_and_goal_locations(int num_of_new_agents)
 	{
 		int loc = path[timestep].location;
 		starts.emplace_back(loc, 0, path[timestep].orientation);
-		if (G.types[loc] == "Entry")
+		if (G.is_type(loc, ENTRY))
 		{
 			available_entries.remove(loc);
 		}
@@ -223,6 +223,8 @@ void OnlineSystem::save_results()
 		output << std::endl;
 	}
 	output.close();
+
+	save_statistics();
 	double runtime = (std::clock() - t) / CLOCKS_PER_SEC;
 	std::cout << "Done! (" << runtime << " s)" << std::endl;
 }
\ No newline at end of file
@@ -27,6 +27,9 @@ void PBS::clear()
     // focal_list_threshold = -1;
     avg_path_length = -1;
     paths.clear();
+    rt_paths.clear();
+    rt_start_paths.clear();
+    rt_initial_constraints.clear();
     nogood.clear();
     // focal_list.clear();
     dfs.clear();
@@ -99,7 +102,7 @@ void PBS::find_conflicts(list<Conflict>& conflicts, int a1, int a2)
 		{
 			int loc1 = paths[a1]->at(timestep).location;
 			int loc2 = paths[a2]->at(timestep).location;
-			if (loc1 == loc2 && G.types[loc1] != "Magic")
+			if (loc1 == loc2 && !G.is_magic(loc1))
 			{
 				conflicts.emplace_back(a1, a2, loc1, -1, timestep);
 				return;
@@ -121,7 +124,7 @@ void PBS::find_conflicts(list<Conflict>& conflicts, int a1, int a2)
 			for (size_t timestep = min_path_length; timestep < paths[a2_]->size(); timestep++)
 			{
 				int loc2 = paths[a2_]->at(timestep).location;
-				if (loc1 == loc2 && G.types[loc1] != "Magic")
+				if (loc1 == loc2 && !G.is_magic(loc1))
 				{
 					conflicts.emplace_back(a1_, a2_, loc1, -1, timestep); // It's at least a semi conflict		
 					return;
@@ -140,7 +143,7 @@ void PBS::find_conflicts(list<Conflict>& conflicts, int a1, int a2)
 			int loc = paths[a1]->at(timestep).location;
 			for (int i = max(0, timestep - k_robust); i <= min(timestep + k_robust, size2 - 1); i++)
 			{
-				if (loc == paths[a2]->at(i).location && G.types[loc] != "Magic")
+				if (loc == paths[a2]->at(i).location && !G.is_magic(loc))
 				{
 					conflicts.emplace_back(a1, a2, loc, -1, min(i, timestep)); // k-robust vertex conflict
 					runtime_detect_conflicts += (double)(std::clock() - t) / CLOCKS_PER_SEC;
@@ -317,9 +320,7 @@ bool PBS::find_path(PBSNode* node, int agent)
     double path_cost;
 
     clock_t t = std::clock();
-	rt.copy(initial_rt);
-    rt.build(paths, initial_constraints, node->priorities.get_reachable_nodes(agent),
-             agent, starts[agent].location);
+    update_rt(node->priorities.get_reachable_nodes(agent), agent);
     runtime_get_higher_priority_agents += node->priorities.runtime;
 
     runtime_rt += (double)(std::clock() - t) / CLOCKS_PER_SEC;
@@ -348,6 +349,7 @@ bool PBS::find_path(PBSNode* node, int agent)
     {
         if (std::get<0>(*it) == agent)
         {
+            forget_rt_path(agent, &it->second);
             node->paths.erase(it);
             break;
         }
@@ -358,6 +360,75 @@ bool PBS::find_path(PBSNode* node, int agent)
 }
 
 
+// update rt incrementally, so that it holds the reservations for planning the path of agent
+void PBS::update_rt(const unordered_set<int>& high_priority_agents, int agent)
+{
+    if (rt_paths.empty()) // the first low-level search of this run
+    {
+        rt.clear();
+        rt.setBase(initial_rt);
+        rt_paths.assign(num_of_agents, nullptr);
+        rt_start_paths.assign(num_of_agents, nullptr);
+        rt_initial_constraints.assign(num_of_agents, false);
+    }
+    clock_t t = std::clock();
+    for (int i = 0; i < num_of_agents; i++)
+    {
+        // hard constraints from the paths of the higher-priority agents
+        const Path* path = high_priority_agents.find(i) != high_priority_agents.end() ? paths[i] : nullptr;
+        if (path != rt_paths[i])
+        {
+            if (path == nullptr)
+                rt.remove(i, PATH_RESERVATION);
+            else
+                rt.insertPath(i, *path);
+            rt_paths[i] = path;
+        }
+        // prohibit the agent from conflicting with other agents at their start locations
+        if (rt.prioritize_start)
+        {
+            path = i != agent ? paths[i] : nullptr;
+            if (path != rt_start_paths[i])
+            {
+                if (path == nullptr)
+                    rt.remove(i, START_RESERVATION);
+                else
+                    rt.insertStartConstraint(i, *path);
+                rt_start_paths[i] = path;
+            }
+        }
+        // initial constraints of the other agents
+        if ((i != agent) != rt_initial_constraints[i])
+        {
+            if (i != agent)
+                rt.insertInitialConstraints(i, initial_constraints);
+            else
+                rt.remove(i, INITIAL_RESERVATION);
+            rt_initial_constraints[i] = i != agent;
+        }
+    }
+    rt.recordBuild(t);
+}
+
+
+// remove the reservations of the path from rt, which must not refer to it once it is deleted
+void PBS::forget_rt_path(int agent, const Path* path)
+{
+    if (rt_paths.empty())
+        return;
+    if (rt_paths[agent] == path)
+    {
+        rt.remove(agent, PATH_RESERVATION);
+        rt_paths[agent] = nullptr;
+    }
+    if (rt_start_paths[agent] == path)
+    {
+        rt.remove(agent, START_RESERVATION);
+        rt_start_paths[agent] = nullptr;
+    }
+}
+
+
 // return true if the agent keeps waiting at its start location until at least timestep
 bool PBS::wait_at_start(const Path& path, int start_location, int timestep)
 {
@@ -559,24 +630,44 @@ bool PBS::generate_root_node()
     }
 
 
+    // with prioritized_root, every agent avoids the agents planned before it
+    PrioritizedPlanner planner(G, path_planner, rt);
+    if (prioritized_root)
+    {
+        clock_t t = std::clock();
+        vector<Path> reserved_paths(num_of_agents);
+        for (int i = 0; i < num_of_agents; i++)
+        {
+            if (paths[i] != nullptr)
+                reserved_paths[i] = *paths[i];
+        }
+        planner.reserve_starts = prioritize_start;
+        planner.init(initial_rt, reserved_paths, initial_constraints);
+        runtime_rt += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+    }
+
     for (int i = 0; i < num_of_agents; i++) 
 	{
         if (paths[i] != nullptr)
             continue;
         Path path;
         double path_cost;
-        int start_location  = starts[i].location;
         clock_t t = std::clock();
-		rt.copy(initial_rt);
-        rt.build(paths, initial_constraints, dummy_start->priorities.get_reachable_nodes(i), i, start_location);
-        runtime_get_higher_priority_agents += dummy_start->priorities.runtime;
-        runtime_rt += (double)(std::clock() - t) / CLOCKS_PER_SEC;
-        vector< vector<double> > h_values(goal_locations[i].size());
-        t = std::clock();
-        path = path_planner.run(G, starts[i], goal_locations[i], rt);
-		runtime_plan_paths += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+        if (prioritized_root)
+        {
+            path = planner.plan(i, starts[i], goal_locations[i]);
+            runtime_plan_paths += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+        }
+        else
+        {
+            update_rt(dummy_start->priorities.get_reachable_nodes(i), i);
+            runtime_get_higher_priority_agents += dummy_start->priorities.runtime;
+            runtime_rt += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+            t = std::clock();
+            path = path_planner.run(G, starts[i], goal_locations[i], rt);
+            runtime_plan_paths += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+        }
         path_cost = path_planner.path_cost;
-        rt.clear();
         LL_num_expanded += path_planner.num_expanded;
         LL_num_generated += path_planner.num_generated;
 
@@ -591,6 +682,8 @@ bool PBS::generate_root_node()
         dummy_start->makespan = std::max(dummy_start->makespan, paths[i]->size() - 1);
         dummy_start->g_val += path_cost;
 	}
+    if (prioritized_root)
+        planner.clear(); // update_rt rebuilds the table on its next call
     find_conflicts(dummy_start->conflicts);
     if (!lazyPriority)
     {
@@ -657,7 +750,7 @@ bool PBS::run(const vector<State>& starts,
     rt.k_robust = k_robust;
     rt.window = window;
 	rt.hold_endpoints = hold_endpoints;
-    path_planner.travel_times = travel_times;
+    path_planner.travel_times = &travel_times;
 	path_planner.hold_endpoints = hold_endpoints;
 	path_planner.prioritize_start = prioritize_start;
 
@@ -740,6 +833,8 @@ bool PBS::run(const vector<State>& starts,
             }
 		    else
 		    {
+			    for (const auto& p : i->paths)
+			        forget_rt_path(p.first, &p.second);
 			    delete i;
 			    i = nullptr;
 		    }
@@ -793,7 +888,7 @@ bool PBS::run(const vector<State>& starts,
         int start_loc = starts[i].location;
         for (const auto& goal : goal_locations[i])
         {
-            min_sum_of_costs += G.heuristics.at(goal.first)[start_loc];
+            min_sum_of_costs += G.get_heuristic(goal.first)[start_loc];
             start_loc = goal.first;
         }
     }
@@ -0,0 +1,61 @@
+#include "PlannerPool.h"
+#include <algorithm>
+
+
+PlannerPool::PlannerPool(BasicGraph& G, SingleAgentSolver& path_planner, int num_threads):
+    G(G), path_planner(path_planner)
+{
+    planners.push_back(&path_planner);
+    for (int i = 1; i < num_threads; i++)
+        planners.push_back(path_planner.clone());
+    if (num_threads > 1)
+        threads.reset(new ThreadPool(num_threads));
+}
+
+
+PlannerPool::~PlannerPool()
+{
+    for (int i = 1; i < (int)planners.size(); i++)
+        delete planners[i];
+}
+
+
+void PlannerPool::run(Query& query, SingleAgentSolver& planner)
+{
+    query.path = planner.run(G, query.start, *query.goal_locations, *query.rt);
+    query.path_cost = planner.path_cost;
+    query.min_f_val = planner.min_f_val;
+    query.num_expanded = planner.num_expanded;
+    query.num_generated = planner.num_generated;
+}
+
+
+void PlannerPool::run(vector<Query>& queries)
+{
+    // Concurrent searches query the heuristics without computing them.
+    // With a memory budget, a table can be evicted by another search, so the searches run one by one.
+    if (threads == nullptr || queries.size() <= 1 || G.heuristics.memory_budget > 0)
+    {
+        for (auto& query : queries)
+            run(query, path_planner);
+        return;
+    }
+    for (auto& query : queries)
+    {
+        // a table that is not finalized updates itself in its queries, so only one search may use it
+        assert(query.rt->isFinalized() || std::count_if(queries.begin(), queries.end(),
+            [&query](const Query& other) { return other.rt == query.rt; }) == 1);
+        for (const auto& goal : *query.goal_locations)
+            G.get_heuristic(goal.first);
+    }
+    for (int i = 1; i < (int)planners.size(); i++)
+        planners[i]->copy_settings(path_planner);
+
+    threads->parallel_for((int)queries.size(), [&](int i, int worker_id)
+    {
+        run(queries[i], *planners[worker_id]);
+    });
+
+    for (int i = 1; i < (int)planners.size(); i++)
+        path_planner.merge_statistics(*planners[i]);
+}
@@ -0,0 +1,57 @@
+#include "PrioritizedPlanner.h"
+
+
+void PrioritizedPlanner::init(const ReservationTable& base, const vector<Path>& initial_paths,
+                              const list< tuple<int, int, int> >& initial_constraints)
+{
+    clock_t t = std::clock();
+    this->initial_constraints = &initial_constraints;
+    rt.clear();
+    rt.setBase(base);
+    for (int i = 0; i < (int)initial_paths.size(); i++)
+    {
+        if (!initial_paths[i].empty())
+        {
+            rt.insertPath(i, initial_paths[i]);
+            if (reserve_starts)
+                rt.insertStartConstraint(i, initial_paths[i]);
+        }
+        rt.insertInitialConstraints(i, initial_constraints);
+    }
+    initial_version = rt.checkpoint();
+    rt.recordBuild(t);
+}
+
+
+void PrioritizedPlanner::restart()
+{
+    clock_t t = std::clock();
+    rt.rollback(initial_version);
+    rt.recordBuild(t);
+}
+
+
+Path PrioritizedPlanner::plan(int agent, const State& start, const vector<pair<int, int> >& goal_locations)
+{
+    clock_t t = std::clock();
+    rt.remove(agent, PATH_RESERVATION);
+    rt.remove(agent, START_RESERVATION);
+    rt.remove(agent, INITIAL_RESERVATION);
+    clock_t update_time = std::clock() - t;
+
+    Path path = path_planner.run(G, start, goal_locations, rt);
+    num_expanded += path_planner.num_expanded;
+    num_generated += path_planner.num_generated;
+    num_of_plans++;
+
+    t = std::clock();
+    if (!path.empty())
+    {
+        rt.insertPath(agent, path);
+        if (reserve_starts)
+            rt.insertStartConstraint(agent, path);
+    }
+    rt.insertInitialConstraints(agent, *initial_constraints);
+    rt.recordBuild(t - update_time); // both updates of the table count as one build
+    return path;
+}
@@ -1,77 +1,342 @@
 #include "ReservationTable.h"
+#include <algorithm>
 
-// update SIT at the given location
-void ReservationTable::updateSIT(size_t location)
+
+void ReservationTable::configureCT()
+{
+	// timesteps after window + k_robust are never constrained by paths, so the dense bitsets do not cover them
+	int horizon = (int)min((long long)window + k_robust + 1, 64LL);
+	ct.configure(ct_mode, getNumOfIds(), horizon);
+}
+
+
+void ReservationTable::clear()
 {
-	if (sit.find(location) == sit.end())
+	sit.clear();
+	ct.clear();
+	cat.clear();
+	base = nullptr;
+	finalized = false;
+	for (int owner = 0; owner < (int)owned.size(); owner++)
 	{
-		const auto& it = ct.find(location);
-		if (it != ct.end())
+		owned[owner] = false;
+		owned_ids[owner].clear();
+	}
+	recording = false;
+	changes.clear();
+}
+
+
+void ReservationTable::copy(const ReservationTable& other)
+{
+	clock_t t = std::clock();
+	configureCT();
+	sit = other.sit;
+	ct.copy(other.ct);
+	if (other.cat.empty())
+		cat.clear(); // keep the buffer of this table
+	else
+		cat = other.cat;
+	owned = other.owned;
+	owned_ids = other.owned_ids;
+	base = other.base;
+	finalized = other.finalized;
+	accumulated_runtime += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+}
+
+
+void ReservationTable::copySettings(const ReservationTable& other)
+{
+	map_size = other.map_size;
+	num_of_agents = other.num_of_agents;
+	k_robust = other.k_robust;
+	window = other.window;
+	use_cat = other.use_cat;
+	hold_endpoints = other.hold_endpoints;
+	ct_mode = other.ct_mode;
+	prioritize_start = other.prioritize_start;
+}
+
+
+void ReservationTable::setBase(const ReservationTable& other)
+{
+	assert(other.finalized || (other.base == nullptr && other.cat.empty()));
+	base = other.ct.empty() && other.cat.empty() && other.base == nullptr ? nullptr : &other;
+	sit.clear(); // the safe intervals depend on the base
+	finalized = false;
+}
+
+
+void ReservationTable::finalize()
+{
+	if (finalized)
+		return;
+	clock_t t = std::clock();
+	auto update = [this](size_t id, const TimeRanges&) { updateSIT(id); };
+	ct.for_each(update);
+	if (base != nullptr && !base->finalized) // the intervals of a finalized base are read from it
+		base->ct.for_each(update);
+	// soft constraints: the vertices with agents and the edges between them
+	cat.for_each_location([this](int location)
+	{
+		updateSIT(location);
+		for (int direction = 0; direction < 4; direction++)
 		{
-			for (auto time_range : it->second)
-				insertConstraint2SIT(location, time_range.first, time_range.second);
-			ct.erase(it);
+			int neighbor = location + G.move[direction];
+			if (neighbor < 0 || neighbor >= (int)map_size)
+				continue;
+			if (G.valid_move(location, direction))
+				updateSIT(getEdgeIndex(location, neighbor));
+			int reverse_direction = G.get_direction(neighbor, location);
+			if (reverse_direction >= 0 && G.valid_move(neighbor, reverse_direction))
+				updateSIT(getEdgeIndex(neighbor, location));
 		}
+	});
+	finalized = true;
+	accumulated_runtime += (double)(std::clock() - t) / CLOCKS_PER_SEC;
+}
+
 
-		if (location < map_size) // vertex
+void ReservationTable::reserve(size_t id, int t_min, int t_max)
+{
+	finalized = false;
+	ct.insert(id, t_min, t_max, current_owner);
+	if (current_owner >= 0)
+		owned_ids[current_owner].push_back(id);
+	if (sit.find(id) != sit.end()) // keep the safe intervals that were already computed up to date
+		insertConstraint2SIT(id, t_min, t_max);
+}
+
+
+// Other agents cannot move from `from` to `to` within k_robust timesteps of timestep.
+// If k_robust > 0, the vertex constraints already prevent it unless one of the locations is a Magic cell.
+void ReservationTable::reserveSwap(int from, int to, int timestep)
+{
+	if (from != to && (k_robust == 0 || G.is_magic(from) || G.is_magic(to)))
+		reserve(getEdgeIndex(from, to), timestep - k_robust, timestep + k_robust + 1);
+}
+
+
+void ReservationTable::beginReservation(int agent, reservation_kind kind)
+{
+	configureCT();
+	int owner = getOwner(agent, kind);
+	if (owner >= (int)owned.size())
+	{
+		owned.resize(owner + 1, false);
+		owned_ids.resize(owner + 1);
+	}
+	else if (owned[owner])
+	{
+		removeOwner(owner);
+	}
+	owned[owner] = true;
+	if (recording)
+		changes.push_back({owner, true, {}});
+	current_owner = owner;
+}
+
+
+void ReservationTable::removeOwner(int owner)
+{
+	finalized = false;
+	Change change{owner, false, {}};
+	auto& ids = owned_ids[owner];
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	TimeRanges removed;
+	for (size_t id : ids)
+	{
+		removed.clear();
+		ct.remove(id, owner, &removed);
+		if (recording)
 		{
-			for (int t = 0; t < (int)cat.size(); t++)
-			{
-				if (cat[t][location])
-				{
-					insertSoftConstraint2SIT(location, t, t + 1);
-				}
-			}
+			for (const auto& range : removed)
+				change.removed_ranges.emplace_back(id, range);
 		}
-		else // edge
+		sit.erase(id); // recomputed from ct and cat on the next query
+	}
+	ids.clear();
+	owned[owner] = false;
+	if (recording)
+		changes.push_back(std::move(change));
+}
+
+
+void ReservationTable::insertPath(int agent, const Path& path)
+{
+	beginReservation(agent, PATH_RESERVATION);
+	insertPath2CT(path);
+	current_owner = -1;
+}
+
+
+void ReservationTable::insertStartConstraint(int agent, const Path& path)
+{
+	beginReservation(agent, START_RESERVATION);
+	int start = path.empty() ? -1 : path.front().location;
+	if (start >= 0 && !G.is_magic(start))
+	{
+		for (const auto& state : path)
 		{
-			auto edge = getEdge(location);
-			for (int t = 1; t < (int)cat.size(); t++)
+			if (state.location != start) // The agent starts to move
 			{
-				if (cat[t][edge.first] && cat[t - 1][edge.second])
-				{
-					insertSoftConstraint2SIT(location, t, t + 1);
-				}
+				// The agent waits at its start locations between [appear_time, state.timestep - 1]
+				// So other agents cannot use this start location between
+				// [appear_time - k_robust, state.timestep + k_robust - 1]
+				reserve(start, 0, state.timestep + k_robust);
+				break;
 			}
 		}
 	}
+	current_owner = -1;
+}
+
+
+void ReservationTable::insertInitialConstraints(int agent, const list< tuple<int, int, int> >& initial_constraints)
+{
+	beginReservation(agent, INITIAL_RESERVATION);
+	for (const auto& con : initial_constraints)
+	{
+		if (std::get<0>(con) == agent && 0 <= std::get<1>(con) && std::get<1>(con) < G.size() &&
+			!G.is_magic(std::get<1>(con)))
+			reserve(std::get<1>(con), 0, min(window, std::get<2>(con)));
+	}
+	current_owner = -1;
+}
+
+
+void ReservationTable::remove(int agent, reservation_kind kind)
+{
+	if (contains(agent, kind))
+		removeOwner(getOwner(agent, kind));
+}
+
+
+int ReservationTable::checkpoint()
+{
+	recording = true;
+	return (int)changes.size();
 }
 
 
-//merge successive safe intervals with the same number of conflicts.
-void ReservationTable::mergeIntervals(list<Interval >& intervals) const
+void ReservationTable::rollback(int version)
 {
-	if (intervals.empty())
+	bool was_recording = recording;
+	recording = false;
+	while ((int)changes.size() > version)
+	{
+		Change change = std::move(changes.back());
+		changes.pop_back();
+		if (change.inserted)
+		{
+			removeOwner(change.owner);
+			continue;
+		}
+		owned[change.owner] = true;
+		current_owner = change.owner;
+		for (const auto& entry : change.removed_ranges)
+			reserve(entry.first, entry.second.t_min, entry.second.t_max);
+		current_owner = -1;
+	}
+	recording = was_recording;
+}
+
+
+// update SIT at the given location
+void ReservationTable::updateSIT(size_t location)
+{
+	if (finalized)
+	{
+		// every location/edge with constraints has its safe intervals already, so the queries only read the table
+		assert(sit.find(location) != sit.end() || (ct.find(location) == nullptr &&
+			(base == nullptr || base->finalized || base->ct.find(location) == nullptr)));
 		return;
-	auto prev = intervals.begin();
-	auto curr = prev;
-	++curr;
-	while (curr != intervals.end())
+	}
+	if (sit.find(location) != sit.end())
+		return;
+	// With a finalized base, the safe intervals start as a copy of the ones of the base,
+	// made only if this table constrains the location as well.
+	bool layered = base != nullptr && base->finalized;
+	auto seed = [&]()
 	{
-		if (std::get<1>(*prev) == std::get<0>(*curr) && std::get<2>(*prev) == std::get<2>(*curr))
+		if (layered && sit.find(location) == sit.end())
 		{
-			*prev = make_tuple(std::get<0>(*prev), std::get<1>(*curr), std::get<2>(*prev));
-			curr = intervals.erase(curr);
+			const vector<Interval>* intervals = base->lookupSIT(location);
+			if (intervals != nullptr)
+				sit[location] = *intervals;
 		}
-		else
+	};
+
+	const TimeRanges* ranges = ct.find(location);
+	if (ranges != nullptr)
+	{
+		seed();
+		for (const auto& time_range : *ranges)
+			insertConstraint2SIT(location, time_range.t_min, time_range.t_max);
+	}
+	ranges = base == nullptr || layered ? nullptr : base->ct.find(location);
+	if (ranges != nullptr)
+	{
+		for (const auto& time_range : *ranges)
+			insertConstraint2SIT(location, time_range.t_min, time_range.t_max);
+	}
+
+	if (location < map_size) // vertex
+	{
+		for (int t = 0; t < cat.size(); t++)
 		{
-			prev = curr;
-			++curr;
+			int num_of_conflicts = cat.get((int)location, t);
+			if (num_of_conflicts > 0)
+			{
+				seed();
+				insertSoftConstraint2SIT(location, t, t + 1, num_of_conflicts);
+			}
+		}
+	}
+	else // edge
+	{
+		// The conflicts on an edge are not the sum of the ones in each layer,
+		// so add the difference between all layers and the base.
+		// cat covers the timesteps of the base (see build), so it covers all conflicts.
+		auto edge = getEdge(location);
+		for (int t = 1; t < cat.size(); t++)
+		{
+			// at most this many agents can move in the opposite direction
+			int num_of_conflicts = getEdgeCATCount(edge, t);
+			if (layered)
+				num_of_conflicts -= base->getEdgeCATCount(edge, t);
+			if (num_of_conflicts > 0)
+			{
+				seed();
+				insertSoftConstraint2SIT(location, t, t + 1, num_of_conflicts);
+			}
 		}
 	}
 }
 
 
+const vector<Interval>* ReservationTable::lookupSIT(size_t id) const
+{
+	auto it = sit.find(id);
+	if (it != sit.end())
+		return &it->second;
+	if (base != nullptr && base->finalized)
+		return base->lookupSIT(id);
+	return nullptr;
+}
+
 
 int ReservationTable::getHoldingTimeFromSIT(int location)
 {
 	updateSIT(location);
-	if (sit.find(location) == sit.end())
+	const vector<Interval>* intervals = lookupSIT(location);
+	if (intervals == nullptr)
 		return 0;
-	int t = std::get<1>(sit[location].back());
+	int t = std::get<1>(intervals->back());
 	if (t < INTERVAL_MAX)
 		return INTERVAL_MAX;
-	for (auto p = sit[location].rbegin(); p != sit[location].rend(); ++p)
+	for (auto p = intervals->rbegin(); p != intervals->rend(); ++p)
 	{
 		if (t == std::get<1>(*p))
 			t = std::get<0>(*p);
@@ -83,117 +348,108 @@ int ReservationTable::getHoldingTimeFromSIT(int location)
 
 int ReservationTable::getHoldingTimeFromCT(int location) const
 {
-	const auto& it = ct.find(location);
-	if (it == ct.end())
-		return 0;
-
-	int t = 0;
-	for (auto time_range : it->second)
-	{
-		if (time_range.second > t)
-			t = time_range.second;
-	}
-	return t;
+	int holding_time = ct.get_holding_time(location);
+	if (base != nullptr)
+		holding_time = max(holding_time, base->getHoldingTimeFromCT(location));
+	return holding_time;
 }
 
 set<int> ReservationTable::getConstrainedTimesteps(int location) const
 {
     set<int> rst;
-    const auto& it = ct.find(location);
-    if (it == ct.end())
+    if (base != nullptr)
+        rst = base->getConstrainedTimesteps(location);
+    const TimeRanges* ranges = ct.find(location);
+    if (ranges == nullptr)
         return rst;
 
-    for (auto time_range : it->second)
+    for (const auto& time_range : *ranges)
     {
-        if (time_range.second == INTERVAL_MAX) // skip goal constraint
+        if (time_range.t_max == INTERVAL_MAX) // skip goal constraint
             continue;
-        for (auto t = time_range.first; t < time_range.second; t++)
+        for (auto t = time_range.t_min; t < time_range.t_max; t++)
             rst.insert(t);
     }
     return rst;
 }
 
-void ReservationTable::insertConstraint2SIT(int location, int t_min, int t_max)
+// remove [t_min, t_max) from the safe intervals of the location
+void ReservationTable::insertConstraint2SIT(size_t location, int t_min, int t_max)
 {
-    if (sit.find(location) == sit.end())
+    auto it = sit.find(location);
+    if (it == sit.end())
     {
+        auto& intervals = sit[location];
         if (t_min > 0)
         {
-			sit[location].emplace_back(0, t_min, 0);
+			intervals.emplace_back(0, t_min, 0);
         }
-		sit[location].emplace_back(t_max, INTERVAL_MAX, 0);
+		intervals.emplace_back(t_max, INTERVAL_MAX, 0);
         return;
     }
-    for (auto it = sit[location].begin(); it != sit[location].end();)
+    auto& intervals = it->second;
+    // intervals[first, last) overlap [t_min, t_max)
+    size_t first = std::upper_bound(intervals.begin(), intervals.end(), t_min,
+            [](int t, const Interval& interval) { return t < std::get<1>(interval); }) - intervals.begin();
+    size_t last = first;
+    while (last < intervals.size() && std::get<0>(intervals[last]) < t_max)
+        last++;
+    if (first == last)
+        return;
+
+    // keep the parts before t_min and after t_max
+    Interval pieces[2];
+    size_t num_of_pieces = 0;
+    if (std::get<0>(intervals[first]) < t_min)
+        pieces[num_of_pieces++] = make_tuple(std::get<0>(intervals[first]), t_min, std::get<2>(intervals[first]));
+    if (t_max < std::get<1>(intervals[last - 1]))
+        pieces[num_of_pieces++] = make_tuple(t_max, std::get<1>(intervals[last - 1]), std::get<2>(intervals[last - 1]));
+    if (num_of_pieces > last - first) // the constraint splits one interval into two
     {
-        if (t_min >= std::get<1>(*it))
-			++it; 
-        else if (t_max <= std::get<0>(*it))
-            break;
-       else  if (std::get<0>(*it) < t_min && std::get<1>(*it) <= t_max)
-        {
-            (*it) = make_tuple(std::get<0>(*it), t_min, 0);
-			++it;
-        }
-        else if (t_min <= std::get<0>(*it) && t_max < std::get<1>(*it))
-        {
-            (*it) = make_tuple(t_max, std::get<1>(*it), 0);
-            break;
-        }
-        else if (std::get<0>(*it) < t_min && t_max < std::get<1>(*it))
-        {
-			sit[location].insert(it, make_tuple(std::get<0>(*it), t_min, 0));
-            (*it) = make_tuple(t_max, std::get<1>(*it), 0);
-            break;
-        }
-        else // constraint_min <= get<0>(*it) && get<1> <= constraint_max
-        {
-            it = sit[location].erase(it);
-        }
+        intervals[first] = pieces[0];
+        intervals.insert(intervals.begin() + first + 1, pieces[1]);
+        return;
     }
+    for (size_t i = 0; i < num_of_pieces; i++)
+        intervals[first + i] = pieces[i];
+    intervals.erase(intervals.begin() + first + num_of_pieces, intervals.begin() + last);
 }
 
-void ReservationTable::insertSoftConstraint2SIT(int location, int t_min, int t_max)
+// add num_of_conflicts to the safe intervals of the location during [t_min, t_max)
+void ReservationTable::insertSoftConstraint2SIT(size_t location, int t_min, int t_max, int num_of_conflicts)
 {
-    if (sit.find(location) == sit.end())
+    auto it = sit.find(location);
+    if (it == sit.end())
     {
+        auto& intervals = sit[location];
         if (t_min > 0)
         {
-			sit[location].emplace_back(0, t_min, false);
+			intervals.emplace_back(0, t_min, 0);
         }
-		sit[location].emplace_back(t_min, t_max, true);
-		sit[location].emplace_back(t_max, INTERVAL_MAX, false);
+		intervals.emplace_back(t_min, t_max, num_of_conflicts);
+		intervals.emplace_back(t_max, INTERVAL_MAX, 0);
         return;
     }
-    for (auto it = sit[location].begin(); it != sit[location].end(); it++)
+    auto& intervals = it->second;
+    size_t i = std::upper_bound(intervals.begin(), intervals.end(), t_min,
+            [](int t, const Interval& interval) { return t < std::get<1>(interval); }) - intervals.begin();
+    for (; i < intervals.size() && std::get<0>(intervals[i]) < t_max; i++)
     {
-        if (t_min >= std::get<1>(*it))
-            continue;
-        else if (t_max <= std::get<0>(*it))
-            break;
-		else if (std::get<2>(*it)) // the interval already has conflicts. No need to update
-			continue;
-
-        if (std::get<0>(*it) < t_min && std::get<1>(*it) <= t_max)
+        int lower = std::get<0>(intervals[i]);
+        int upper = std::get<1>(intervals[i]);
+        int conflicts = std::get<2>(intervals[i]);
+        if (lower < t_min)
         {
-			sit[location].insert(it, make_tuple(std::get<0>(*it), t_min, false));
-			(*it) = make_tuple(t_min, std::get<1>(*it), true);
+            intervals.insert(intervals.begin() + i, make_tuple(lower, t_min, conflicts));
+            i++;
+            lower = t_min;
         }
-        else if (t_min <= std::get<0>(*it) && t_max < std::get<1>(*it))
+        if (t_max < upper)
         {
-			sit[location].insert(it, make_tuple(std::get<0>(*it), t_max, true));
-            (*it) = make_tuple(t_max, std::get<1>(*it), false);
-        }
-        else if (std::get<0>(*it) < t_min && t_max < std::get<1>(*it))
-        {
-			sit[location].insert(it, make_tuple(std::get<0>(*it), t_min, false));
-			sit[location].insert(it, make_tuple(t_min, t_max,  true));
-            (*it) = make_tuple(t_max, std::get<1>(*it), false);
-        }
-        else // constraint_min <= get<0>(*it) && get<1> <= constraint_max
-        {
-            (*it) = make_tuple(std::get<0>(*it), std::get<1>(*it), true);
+            intervals.insert(intervals.begin() + i + 1, make_tuple(t_max, upper, conflicts));
+            upper = t_max;
         }
+        intervals[i] = make_tuple(lower, upper, conflicts + num_of_conflicts);
     }
 }
 
@@ -202,6 +458,7 @@ void ReservationTable::insertPath2CT(const Path& path)
 {
 	if (path.empty())
 		return;
+	configureCT();
 	auto prev = path.begin();
 	auto curr = path.begin();
 	++curr;
@@ -209,45 +466,36 @@ void ReservationTable::insertPath2CT(const Path& path)
 	{
 		if (prev->location != curr->location)
 		{
-			if (G.types[prev->location] != "Magic")
-				ct[prev->location].emplace_back(prev->timestep - k_robust, curr->timestep + k_robust);
-			if (k_robust == 0) // add edge constraint
-			{
-				ct[getEdgeIndex(curr->location, prev->location)].emplace_back(curr->timestep, curr->timestep + 1);
-			}
+			if (!G.is_magic(prev->location))
+				reserve(prev->location, prev->timestep - k_robust, curr->timestep + k_robust);
+			reserveSwap(curr->location, prev->location, curr->timestep);
 			prev = curr;
 		}
 		++curr;
 	}
 	if (curr != path.end())
 	{
-		if (G.types[prev->location] != "Magic")
-			ct[prev->location].emplace_back(prev->timestep - k_robust, curr->timestep + k_robust);
-		if (k_robust == 0) // add edge constraint
-		{
-			ct[getEdgeIndex(curr->location, prev->location)].emplace_back(curr->timestep, curr->timestep + 1);
-		}
+		if (!G.is_magic(prev->location))
+			reserve(prev->location, prev->timestep - k_robust, curr->timestep + k_robust);
+		reserveSwap(curr->location, prev->location, curr->timestep);
 	}
 	else
 	{
-		if (G.types[prev->location] != "Magic")
-			ct[prev->location].emplace_back(prev->timestep - k_robust, path.back().timestep + 1 + k_robust);
-		if (k_robust == 0) // add edge constraint
-		{
-			ct[getEdgeIndex(path.back().location, prev->location)].emplace_back(path.back().timestep, path.back().timestep + 1);
-		}
+		if (!G.is_magic(prev->location))
+			reserve(prev->location, prev->timestep - k_robust, path.back().timestep + 1 + k_robust);
+		reserveSwap(path.back().location, prev->location, path.back().timestep);
 	}
-	if (hold_endpoints && G.types[prev->location] != "Magic")
-		ct[path.back().location].emplace_back(path.back().timestep, INTERVAL_MAX);
+	if (hold_endpoints && !G.is_magic(prev->location))
+		reserve(path.back().location, path.back().timestep, INTERVAL_MAX);
 }
 
 void ReservationTable::addInitialConstraints(const list< tuple<int, int, int> >& initial_constraints, int current_agent)
 {
 	for (auto con : initial_constraints)
 	{
-		if (std::get<0>(con) != current_agent && 0 <= std::get<1>(con) && std::get<1>(con) < G.types.size() &&
-			G.types[std::get<1>(con)] != "Magic")
-			ct[std::get<1>(con)].emplace_back(0, min(window, std::get<2>(con)));
+		if (std::get<0>(con) != current_agent && 0 <= std::get<1>(con) && std::get<1>(con) < G.size() &&
+			!G.is_magic(std::get<1>(con)))
+			reserve(std::get<1>(con), 0, min(window, std::get<2>(con)));
 	}
 }
 
@@ -258,93 +506,31 @@ void ReservationTable::insertPath2CAT(const Path& path)
 	if (path.empty())
 		return;
 	int max_timestep = min((int)path.size() - 1, k_robust + window);
-	int timestep = 0;
-	while (timestep <= max_timestep)
-	{
-		int location = path[timestep].location;
-		if (G.types[location] != "Magic")
-		{
-			for (int t = max(0, timestep - k_robust); t <= min((int)cat.size() - 1, timestep + k_robust); t++)
-			{
-				cat[t][location] = true;
-			}
-		}
-		timestep++;
-	}
-	if (G.types[path.back().location] != "Magic")
+	vector<int> locations; // the locations of the path at timestep t (up to k_robust), each counted once
+	for (int t = 0; t < cat.size(); t++)
 	{
-		while (timestep < (int)cat.size()) // assume that the agent waits at its last location
+		locations.clear();
+		for (int timestep = max(0, t - k_robust); timestep <= min(max_timestep, t + k_robust); timestep++)
+			locations.push_back(path[timestep].location);
+		if (t > max_timestep) // assume that the agent waits at its last location
+			locations.push_back(path.back().location);
+		for (size_t i = 0; i < locations.size(); i++)
 		{
-			cat[timestep][path.back().location] = true;
-			timestep++;
+			if (!G.is_magic(locations[i]) &&
+				std::find(locations.begin(), locations.begin() + i, locations[i]) == locations.begin() + i)
+				cat.add(locations[i], t, 1);
 		}
 	}
 }
 
-// For PBS
-void ReservationTable::build(const vector<Path*>& paths,
-        const list< tuple<int, int, int> >& initial_constraints,
-        const unordered_set<int>& high_priority_agents, int current_agent, int start_location)
-{
-    clock_t t = std::clock();
-
-    // add hard constraints
-    vector<bool> soft(num_of_agents, true);
-    for (auto i : high_priority_agents)
-    {
-        if (paths[i] == nullptr)
-            continue;
-		insertPath2CT(*paths[i]);
-		soft[i] = false;
-    }
-
-    if (prioritize_start) // prioritize waits at start locations
-    {
-        insertConstraints4starts(paths, current_agent, start_location);
-    }
-
-	addInitialConstraints(initial_constraints, current_agent); // add initial constraints
-   
-    runtime = (std::clock() - t) * 1.0  / CLOCKS_PER_SEC;
-    if (!use_cat)
-        return;
-
-    // add soft constraints
-    soft[current_agent] = false;
-    for (int i = 0; i < num_of_agents; i++)
-    {
-        if(!soft[i] || paths[i] == nullptr)
-            continue;
-		insertPath2CAT(*paths[i]);
-    }
-
-    runtime = (std::clock() - t) * 1.0  / CLOCKS_PER_SEC;
-}
-
-// For WHCA*
-void ReservationTable::build(const vector<Path>& paths,
-                            const list< tuple<int, int, int> >& initial_constraints,
-                            int current_agent)
-{
-    clock_t t = std::clock();
-    // add hard constraints
-    for (int i = 0; i < (int)paths.size(); i++)
-    {
-		if (i == current_agent)
-			continue;
-		insertPath2CT(paths[i]);
-    }
-
-	addInitialConstraints(initial_constraints, current_agent); // add initial constraints
-    runtime = (std::clock() - t) * 1.0  / CLOCKS_PER_SEC;
-}
-
 // For ECBS
 void ReservationTable::build(const vector<Path*>& paths,
                             const list< tuple<int, int, int> >& initial_constraints,
                             const list< Constraint >& hard_constraints, int current_agent)
 {
     clock_t t = std::clock();
+    finalized = false;
+    configureCT();
     // add hard constraints
     for (auto con : hard_constraints)
     {
@@ -353,13 +539,14 @@ void ReservationTable::build(const vector<Path*>& paths,
            // insert_positive_constraint(std::get<1>(con), std::get<3>(con));
 		   // TODO: insert positive constraints
         }
-		else if (std::get<2>(con) < 0 && G.types[std::get<1>(con)] != "Magic") // vertex constraint
+		else if (std::get<2>(con) < 0) // vertex constraint
         {
-			ct[std::get<1>(con)].emplace_back(std::get<3>(con), std::get<3>(con) + 1);
+			if (!G.is_magic(std::get<1>(con)))
+				reserve(std::get<1>(con), std::get<3>(con), std::get<3>(con) + 1);
         }
 		else // edge constraint
 		{
-			ct[getEdgeIndex(std::get<1>(con), std::get<2>(con))].emplace_back(std::get<3>(con), std::get<3>(con) + 1);
+			reserve(getEdgeIndex(std::get<1>(con), std::get<2>(con)), std::get<3>(con), std::get<3>(con) + 1);
 		}
     }
 
@@ -367,7 +554,7 @@ void ReservationTable::build(const vector<Path*>& paths,
 
     /* add soft constraints */
 	// compute the max timestep that cat needs
-	size_t cat_size = 0;
+	int cat_size = 0;
     for (int i = 0; i < num_of_agents; i++)
     {
         if(i == current_agent || paths[i] == nullptr)
@@ -378,10 +565,12 @@ void ReservationTable::build(const vector<Path*>& paths,
 			cat_size = window;
 			break;
 		}
-		else if (cat_size < paths[i]->size())
-			cat_size = paths[i]->size();
+		else if (cat_size < (int)paths[i]->size())
+			cat_size = (int)paths[i]->size();
 	}
-	cat.resize(cat_size, vector<bool>(map_size));
+	if (base != nullptr) // cover the timesteps of the soft constraints in the base as well
+		cat_size = max(cat_size, base->cat.size());
+	cat.reset(map_size, cat_size);
 
 	// build cat
 	for (int i = 0; i < num_of_agents; i++)
@@ -391,102 +580,35 @@ void ReservationTable::build(const vector<Path*>& paths,
 		
        insertPath2CAT(*paths[i]);
     }
-    runtime = (std::clock() - t) * 1.0  / CLOCKS_PER_SEC;
+    recordBuild(t);
 }
 
 
-void ReservationTable::insertConstraints4starts(const vector<Path*>& paths, int current_agent, int start_location)
-{
-    for (int i = 0; i < num_of_agents; i++)
-    {
-        if (paths[i] == nullptr)
-            continue;
-        else if (i != current_agent)// prohibit the agent from conflicting with other agents at their start locations
-        {
-            int start = paths[i]->front().location;
-            if (start < 0 || G.types[start] == "Magic")
-                continue;
-            for (auto state : (*paths[i]))
-            {
-                if (state.location != start) // The agent starts to move
-                {
-                    // The agent waits at its start locations between [appear_time, state.timestep - 1]
-                    // So other agents cannot use this start location between
-                    // [appear_time - k_robust, state.timestep + k_robust - 1]
-                    ct[start].emplace_back(0, state.timestep + k_robust);
-                    break;
-                }
-            }
-        }
-    }
-}
+const Interval ReservationTable::full_interval(0, INTERVAL_MAX, 0);
 
-// [lower_bound, upper_bound)
-list<Interval> ReservationTable::getSafeIntervals(int location, int lower_bound, int upper_bound)
+const Interval* ReservationTable::findSafeIntervals(size_t id, int lower_bound, const Interval*& end)
 {
-    list<Interval> safe_intervals;
-    if (lower_bound >= upper_bound)
-        return safe_intervals;
-
-	updateSIT(location);
-	
-	auto it = sit.find(location);
-    if (it == sit.end()) 
-    {
-		safe_intervals.emplace_back(0, INTERVAL_MAX, 0);
-		return safe_intervals;
-    }
-
-    for(auto interval : it->second)
-    {
-        if (lower_bound >= std::get<1>(interval))
-            continue;
-        else if (upper_bound <= std::get<0>(interval))
-            break;
-        else
-        {
-            safe_intervals.emplace_back(interval);
-        }
-
-    }
-    return safe_intervals;
-}
-
-// [lower_bound, upper_bound)
-list<Interval> ReservationTable::getSafeIntervals(int from, int to, int lower_bound, int upper_bound)
-{
-	if (lower_bound >= upper_bound)
-		return list<Interval>();
-	
-	auto safe_vertex_intervals = getSafeIntervals(to, lower_bound, upper_bound);
-	auto safe_edge_intervals = getSafeIntervals(getEdgeIndex(from, to), lower_bound, upper_bound);
-
-	list<Interval> safe_intervals;
-	auto it1 = safe_vertex_intervals.begin();
-	auto it2 = safe_edge_intervals.begin();
-	while (it1 != safe_vertex_intervals.end() && it2 != safe_edge_intervals.end())
+	updateSIT(id);
+	const vector<Interval>* intervals = lookupSIT(id);
+	if (intervals == nullptr)
 	{
-		int t_min = max(std::get<0>(*it1), std::get<0>(*it2));
-		int t_max = min(std::get<1>(*it1), std::get<1>(*it2));
-		if (t_min < t_max)
-			safe_intervals.emplace_back(t_min, t_max, std::get<2>(*it1) + std::get<2>(*it2));
-		if (t_max == std::get<1>(*it1))
-			++it1;
-		if (t_max == std::get<1>(*it2))
-			++it2;
+		end = &full_interval + 1;
+		return &full_interval;
 	}
-	return safe_intervals;
+	end = intervals->data() + intervals->size();
+	return std::upper_bound(intervals->data(), end, lower_bound,
+			[](int t, const Interval& interval) { return t < std::get<1>(interval); });
 }
 
 Interval ReservationTable::getFirstSafeInterval(int location)
 {
 	updateSIT(location);
-    auto it = sit.find(location);
-    if (it == sit.end())
+    const vector<Interval>* intervals = lookupSIT(location);
+    if (intervals == nullptr)
     {
 		return Interval(0, INTERVAL_MAX, 0);
     }
-    return it->second.front();
+    return intervals->front();
 }
 
 // find a safe interval with t_min as given
@@ -494,22 +616,17 @@ bool ReservationTable::findSafeInterval(Interval& interval, int location, int t_
 {
 	updateSIT(location);
 
-    auto it = sit.find(location);
-    if (it == sit.end())
+    const vector<Interval>* intervals = lookupSIT(location);
+    if (intervals == nullptr)
     {
 		return t_min == 0;
     }
-    for( auto i : it->second)
-    {
-        if (t_min == std::get<0>(i))
-        {
-            interval = i;
-            return true;
-        }
-        else if (t_min < std::get<0>(i))
-            break;
-    }
-    return false;
+    auto i = std::lower_bound(intervals->begin(), intervals->end(), t_min,
+            [](const Interval& interval, int t) { return std::get<0>(interval) < t; });
+    if (i == intervals->end() || std::get<0>(*i) != t_min)
+        return false;
+    interval = *i;
+    return true;
 }
 
 
@@ -529,57 +646,35 @@ void ReservationTable::print() const
 void ReservationTable::printCT(size_t location) const
 {
     cout << "loc=" << location << ":";
-    const auto it = ct.find(location);
-    if (it != ct.end())
+    const TimeRanges* ranges = ct.find(location);
+    if (ranges != nullptr)
     {
-        for (const auto & interval : ct.at(location))
-        cout << "[" << std::get<0>(interval) << "," << std::get<1>(interval) << "],";
+        for (const auto & interval : *ranges)
+        cout << "[" << interval.t_min << "," << interval.t_max << "],";
     }
-    cout << endl;
+    if (base != nullptr)
+        base->printCT(location);
+    else
+        cout << endl;
 }
 
 
 bool ReservationTable::isConstrained(int curr_id, int next_id, int next_timestep) const
 {
-	auto it = ct.find(next_id);
-	if (it != ct.end())
-	{
-		for (auto time_range : it->second)
-		{
-			if (next_timestep >= time_range.first && next_timestep < time_range.second)
-				return true;
-		}
-	}
-
-	if (curr_id != next_id)
-	{
-		it = ct.find(getEdgeIndex(curr_id, next_id));
-		if (it != ct.end())
-		{
-			for (auto time_range : it->second)
-			{
-				if (next_timestep >= time_range.first && next_timestep < time_range.second)
-					return true;
-			}
-		}
-	}
-	return false;
+	if (ct.is_constrained(next_id, next_timestep))
+		return true;
+	if (curr_id != next_id && ct.is_constrained(getEdgeIndex(curr_id, next_id), next_timestep))
+		return true;
+	return base != nullptr && base->isConstrained(curr_id, next_id, next_timestep);
 }
 
 
-bool ReservationTable::isConflicting(int curr_id, int next_id, int next_timestep) const
+int ReservationTable::getNumOfConflicts(int curr_id, int next_id, int next_timestep) const
 {
-	if (next_timestep >= (int)cat.size())
-		return false;
-
-	// check vertex constraints (being in next_id at next_timestep is disallowed)
-	if (cat[next_timestep][next_id])
-		return true;
-	// check edge constraints (the move from curr_id to next_id at next_timestep-1 is disallowed)
-	// which means that res_table is occupied with another agent for [curr_id,next_timestep] and [next_id,next_timestep-1]
-	// WRONG!
-	else if (curr_id != next_id && cat[next_timestep][curr_id] && cat[next_timestep - 1][next_id])
-		return true;
-	else
-		return false;
-}
\ No newline at end of file
+	// vertex conflicts (other agents are in next_id at next_timestep)
+	int num_of_conflicts = getCATCount(next_id, next_timestep);
+	// edge conflicts (other agents may move from next_id to curr_id at next_timestep-1)
+	if (curr_id != next_id)
+		num_of_conflicts += getEdgeCATCount(make_pair(curr_id, next_id), next_timestep);
+	return num_of_conflicts;
+}
@@ -38,6 +38,13 @@ Path SIPP::updatePath(BasicGraph& G, const SIPPNode* goal)
                 path[t] = State(prev->state.location, t, curr->state.orientation); // turn right
                 t++;
             }
+            int distance = G.get_Manhattan_distance(prev->state.location, curr->state.location);
+            if (distance > 1) // a jump point, which is reached by moving straight without waiting
+            {
+                int step = (curr->state.location - prev->state.location) / distance;
+                for (int location = prev->state.location + step; t < curr->state.timestep; t++, location += step)
+                    path[t] = State(location, t, curr->state.orientation);
+            }
             while ( t < curr->state.timestep)
             {
                 path[t] = State(prev->state.location, t, curr->state.orientation); // wait at prev location
@@ -53,16 +60,59 @@ Path SIPP::updatePath(BasicGraph& G, const SIPPNode* goal)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // return true if a path found (and updates vector<int> path) or false if no path exists
-// after max_timestep, switch from time-space A* search to normal A* search
+// if windowed, after window + k_robust, follow the heuristic to the goals instead of searching in time-space
 Path SIPP::run(BasicGraph& G, const State& start,
                const vector<pair<int, int> >& goal_location,
                ReservationTable& rt)
+{
+    Path path;
+    switch (get_queue_policy(G))
+    {
+    case BUCKET_QUEUE:
+        path = search(G, start, goal_location, rt, context.bucket_open, context.heap_focal);
+        break;
+    case DARY_HEAP_QUEUE:
+        path = search(G, start, goal_location, rt, context.heap_open, context.heap_focal);
+        break;
+    default:
+        path = search(G, start, goal_location, rt, context.fibonacci_open, context.fibonacci_focal);
+    }
+    if (validate_jump_points && jumping)
+        validateJumpPoints(G, start, goal_location, rt, path);
+    return path;
+}
+
+
+// The plain search runs on its own planner, so the statistics of this one only count the search with jump points.
+void SIPP::validateJumpPoints(BasicGraph& G, const State& start, const vector<pair<int, int> >& goal_location,
+                              ReservationTable& rt, const Path& path)
+{
+    if (plain_sipp == nullptr)
+        plain_sipp.reset(new SIPP());
+    plain_sipp->copy_settings(*this);
+    plain_sipp->windowed = windowed;
+    Path plain_path = plain_sipp->run(G, start, goal_location, rt);
+    if (path.empty() != plain_path.empty() || (!path.empty() && path_cost != plain_sipp->path_cost))
+    {
+        std::cout << "Jump points change the path cost from " << start.location << " to " << goal_location.back().first
+                  << ": " << (path.empty() ? -1 : path_cost) << " instead of "
+                  << (plain_path.empty() ? -1 : plain_sipp->path_cost) << "!" << std::endl;
+        exit(-1);
+    }
+}
+
+
+template <typename Open, typename Focal>
+Path SIPP::search(BasicGraph& G, const State& start,
+                  const vector<pair<int, int> >& goal_location,
+                  ReservationTable& rt, Open& open_list, Focal& focal_list)
 {
     num_expanded = 0;
     num_generated = 0;
     runtime = 0;
-    clock_t t = std::clock();
-	double h_val = compute_h_value(G, start.location, 0, goal_location);
+    auto t = std::chrono::steady_clock::now();
+	prepare_heuristics(G, goal_location);
+	double h_val = get_h_value(G, start.location, 0, goal_location);
 	if (h_val > INT_MAX)
 	{
 		cout << "The start and goal locations are disconnected!" << endl;
@@ -72,14 +122,14 @@ Path SIPP::run(BasicGraph& G, const State& start,
 	
     if (std::get<0>(interval) == 0)
     {
-        auto node = new SIPPNode(start, 0, h_val, interval, nullptr, 0);
+        auto node = context.nodes.create(start, 0, h_val, interval, nullptr, 0);
         num_generated++;
-        node->open_handle = open_list.push(node);
+        open_list.push(node);
         node->in_openlist = true;
-        allNodes_table.insert(node);
+        context.allNodes_table.insert(node);
         min_f_val = node->getFVal();
         focal_bound = min_f_val * suboptimal_bound;
-        node->focal_handle = focal_list.push(node);
+        focal_list.push(node);
     }
     else if(prioritize_start) // the agent has the highest priority at its start location
     {
@@ -87,22 +137,29 @@ Path SIPP::run(BasicGraph& G, const State& start,
         // wait at its start locations due to initial constraints caused by the previous actions
         // of other agents.
         Interval interval = make_tuple(0, INTERVAL_MAX, 0);
-        auto node = new SIPPNode(start, 0, h_val, interval, nullptr, 0);
+        auto node = context.nodes.create(start, 0, h_val, interval, nullptr, 0);
         num_generated++;
-        node->open_handle = open_list.push(node);
+        open_list.push(node);
         node->in_openlist = true;
-        allNodes_table.insert(node);
+        context.allNodes_table.insert(node);
         min_f_val = node->getFVal();
         focal_bound = min_f_val;
-        node->focal_handle = focal_list.push(node);
+        focal_list.push(node);
     }
 	int earliest_holding_time = 0;
 	if (hold_endpoints)
 		earliest_holding_time = rt.getHoldingTimeFromSIT(goal_location.back().first);
+	bool follow_heuristic = windowed && G.heuristic == SHORTEST_PATH && G.has_integer_weights() &&
+	        start.orientation < 0 && !has_travel_times() && rt.window < INTERVAL_MAX;
+	Path tail;
+	jumping = jump_points && start.orientation < 0 && !rt.use_cat && G.has_uniform_weights() &&
+	        !has_travel_times();
+	if (jumping)
+		updateFreeTimes(G, rt);
     while (!focal_list.empty())
     {
         SIPPNode* curr = focal_list.top(); focal_list.pop();
-        open_list.erase(curr->open_handle);
+        open_list.erase(curr);
         curr->in_openlist = false;
         num_expanded++;
 
@@ -120,15 +177,27 @@ Path SIPP::run(BasicGraph& G, const State& start,
 		{
 			Path path = updatePath(G, curr);
 			releaseClosedListNodes();
-			open_list.clear();
-			focal_list.clear();
-			runtime = (std::clock() - t) * 1.0 / CLOCKS_PER_SEC;
+			record_search(t);
 			return path;
 		}
 
+		// beyond the window, the rest of the path follows the heuristic unless it runs into a reservation
+		if (follow_heuristic && curr->state.timestep >= rt.window + rt.k_robust)
+		{
+			if (followHeuristic(G, curr, goal_location, rt, earliest_holding_time, tail))
+			{
+				Path path = updatePath(G, curr);
+				path.insert(path.end(), tail.begin(), tail.end());
+				releaseClosedListNodes();
+				record_search(t);
+				return path;
+			}
+			follow_heuristic = false; // search the rest of the way
+		}
 
         // expand the nodes
-        for (int orientation = 0; orientation < 4; orientation++) // move
+        bool jumped = jumping && generateJumpPoints(G, curr, goal_location, rt, open_list, focal_list);
+        for (int orientation = 0; orientation < 4 && !jumped; orientation++) // move
         {
             if (!G.valid_move(curr->state.location, orientation)) // the edge is blocked
                 continue;
@@ -140,17 +209,17 @@ Path SIPP::run(BasicGraph& G, const State& start,
             if (degree > std::get<1>(curr->interval) - curr->state.timestep) // don't have enough time to turn
                 continue;
             int location = curr->state.location + G.move[orientation];
-            double h_val = compute_h_value(G, location, curr->goal_id, goal_location);
+            double h_val = get_h_value(G, location, curr->goal_id, goal_location);
             if (h_val > INT_MAX)   // This vertex cannot reach the goal vertex
                 continue;
             int min_timestep = curr->state.timestep + degree + 1;
-            for (auto interval : rt.getSafeIntervals(curr->state.location, location, min_timestep, std::get<1>(curr->interval) + 1))
+            int next_orientation = curr->state.orientation < 0 ? -1 : orientation;
+            rt.forEachSafeInterval(curr->state.location, location, min_timestep, std::get<1>(curr->interval) + 1,
+                    [&](const Interval& interval)
             {
-                if (curr->state.orientation < 0)
-                    generate_node(interval, curr, G, location, min_timestep, -1, h_val);
-                else
-                    generate_node(interval, curr, G, location, min_timestep, orientation, h_val);
-            }
+                generate_node(interval, curr, G, location, min_timestep, next_orientation, h_val,
+                              open_list, focal_list);
+            });
 
         }  // end for loop that generates successors
 
@@ -165,15 +234,20 @@ Path SIPP::run(BasicGraph& G, const State& start,
             {
 				if (curr->state.orientation < 0)
 				{
-					generate_node(interval, curr, G, location, min_timestep, -1, curr->h_val);
+					generate_node(interval, curr, G, location, min_timestep, -1, curr->h_val,
+					              open_list, focal_list);
 				}
 				else
 				{
-					generate_node(interval, curr, G, location, min_timestep, orientation, curr->h_val);
-					generate_node(interval, curr, G, location, min_timestep, (orientation + 1) % 4, curr->h_val);
-					generate_node(interval, curr, G, location, min_timestep, (orientation + 3) % 4, curr->h_val);
+					generate_node(interval, curr, G, location, min_timestep, orientation, curr->h_val,
+					              open_list, focal_list);
+					generate_node(interval, curr, G, location, min_timestep, (orientation + 1) % 4, curr->h_val,
+					              open_list, focal_list);
+					generate_node(interval, curr, G, location, min_timestep, (orientation + 3) % 4, curr->h_val,
+					              open_list, focal_list);
 					if (std::get<1>(curr->interval) - curr->state.timestep > 1)
-						generate_node(interval, curr, G, location, min_timestep, (orientation + 2) % 4, curr->h_val);
+						generate_node(interval, curr, G, location, min_timestep, (orientation + 2) % 4, curr->h_val,
+						              open_list, focal_list);
 				}
             }
         }
@@ -188,15 +262,25 @@ Path SIPP::run(BasicGraph& G, const State& start,
                 // of other agents.
                 Interval interval = rt.getFirstSafeInterval(start.location);
                 Interval interval2 = make_tuple(std::get<1>(interval), INTERVAL_MAX, 0);
-                double h_val = compute_h_value(G, start.location, 0, goal_location);
-                auto node2 = new SIPPNode(start, 0, h_val, interval2, nullptr, 0);
-                num_generated++;
-                node2->open_handle = open_list.push(node2);
+                double h_val = get_h_value(G, start.location, 0, goal_location);
+                SIPPNode candidate(start, 0, h_val, interval2, nullptr, 0);
+                SIPPNode* node2 = context.allNodes_table.find(&candidate);
+                if (node2 == nullptr)
+                {
+                    node2 = context.nodes.create(candidate);
+                    num_generated++;
+                    context.allNodes_table.insert(node2);
+                }
+                else if (node2->getFVal() > candidate.getFVal() ||
+                         (node2->getFVal() == candidate.getFVal() && node2->conflicts > candidate.conflicts))
+                    *node2 = candidate; // reopen it from the start (it is closed, as OPEN is empty)
+                else // it was expanded at least as cheaply
+                    break;
+                open_list.push(node2);
                 node2->in_openlist = true;
-                allNodes_table.insert(node2);
                 min_f_val = node2->getFVal();
                 focal_bound = min_f_val;
-                node2->focal_handle = focal_list.push(node2);
+                focal_list.push(node2);
             }
             else
             {
@@ -210,11 +294,8 @@ Path SIPP::run(BasicGraph& G, const State& start,
             {
                 double new_min_f_val = open_head->getFVal();
                 double new_focal_bound = new_min_f_val * suboptimal_bound;
-                for (SIPPNode* n : open_list)
-                {
-                    if (n->getFVal() > focal_bound && n->getFVal() <= new_focal_bound)
-                        n->focal_handle = focal_list.push(n);
-                }
+                open_list.for_each_in_range(focal_bound, new_focal_bound,
+                                            [&focal_list](SIPPNode* n) { focal_list.push(n); });
                 min_f_val = new_min_f_val;
                 focal_bound = new_focal_bound;
             }
@@ -224,8 +305,7 @@ Path SIPP::run(BasicGraph& G, const State& start,
 
     // no path found
     releaseClosedListNodes();
-    open_list.clear();
-    focal_list.clear();
+    record_search(t);
     return Path();
 }
 
@@ -342,22 +422,32 @@ Path SIPP::run(BasicGraph& G, const State& start,
 }*/
 
 
+template <typename Open, typename Focal>
 void SIPP::generate_node(const Interval& interval, SIPPNode* curr, BasicGraph& G,
-        int location, int min_timestep, int orientation, double h_val)
+        int location, int min_timestep, int orientation, double h_val,
+        Open& open_list, Focal& focal_list, int from)
 {
+    if (from < 0)
+        from = curr->state.location;
     int timestep  = max(std::get<0>(interval), min_timestep);
-    int wait_time = timestep - curr->state.timestep - 1; // inlcude rotate time
+    int wait_time = timestep - curr->state.timestep - 1; // inlcude rotate time (or the moves before from)
     double g_val = curr->g_val + wait_time * G.get_weight(curr->state.location, curr->state.location)
-                   + G.get_weight(curr->state.location, location);
+                   + G.get_weight(from, location);
 
     int conflicts = std::get<2>(interval) + curr->conflicts;
 
-    // generate (maybe temporary) node
-    auto next = new SIPPNode(State(location, timestep, orientation),
-                             g_val, h_val, interval, curr, conflicts);
+    // generate a temporary node, which is copied to the arena only if it is new
+    SIPPNode candidate(State(location, timestep, orientation), g_val, h_val, interval, curr, conflicts);
+    SIPPNode* next = &candidate;
+    if (jumping) // a move after waiting (or a wait) is treated like moves in all directions
+    {
+        int dir = G.get_direction(from, location);
+        bool waited = from == curr->state.location && timestep > curr->state.timestep + 1;
+        next->jump_dirs = (dir < 4 && !waited) ? 1 << dir : 0xF;
+    }
 
     // try to retrieve it from the hash table
-    auto it = allNodes_table.find(next);
+    SIPPNode* existing_next = context.allNodes_table.find(next);
     /*if (it != allNodes_table.end() && (*it)->state.timestep != next->state.timestep)
     { // arrive at the same interval at different timestep
         int waiting_time = (*it)->state.timestep - next->state.timestep;
@@ -374,27 +464,42 @@ void SIPP::generate_node(const Interval& interval, SIPPNode* curr, BasicGraph& G
         else // next arrives with a smaller cost, so they cannot be regarded as the same state
             it = allNodes_table.end(); // TODO: fix this bug! When later inserting this node to allNodes_table, it will not override the previous node.
     }*/
-    if (it == allNodes_table.end())
+    if (existing_next == nullptr)
     {
-        next->open_handle = open_list.push(next);
+        next = context.nodes.create(candidate);
+        open_list.push(next);
         next->in_openlist = true;
         num_generated++;
         if (next->getFVal() <= focal_bound)
-            next->focal_handle = focal_list.push(next);
-        allNodes_table.insert(next);
+            focal_list.push(next);
+        context.allNodes_table.insert(next);
         return;
     }
 
     // update existing node if needed (only in the open_list)
-    SIPPNode* existing_next = *it;
     double existing_f_val = existing_next->getFVal();
 
+    if (jumping && existing_f_val == g_val + h_val && existing_next->conflicts == conflicts &&
+        (next->jump_dirs & ~existing_next->jump_dirs))
+    {  // the same cost from other directions, which may lead to other jump points
+        existing_next->jump_dirs |= next->jump_dirs;
+        if (!existing_next->in_openlist) // so expand it again
+        {
+            open_list.push(existing_next);
+            existing_next->in_openlist = true;
+            if (existing_f_val <= focal_bound)
+                focal_list.push(existing_next);
+        }
+        return;
+    }
+
     if (existing_next->in_openlist)
     {  // if its in the open list
         if (existing_f_val > g_val + h_val ||
             (existing_f_val == g_val + h_val && existing_next->conflicts > conflicts))
         {
             // if f-val decreased through this new path (or it remains the same and there's less internal conflicts)
+            existing_next->jump_dirs = next->jump_dirs;
             bool add_to_focal = false;  // check if it was above the focal bound before and now below (thus need to be inserted)
             bool update_in_focal = false;  // check if it was inside the focal and needs to be updated (because f-val changed)
             bool update_open = false;
@@ -417,11 +522,11 @@ void SIPP::generate_node(const Interval& interval, SIPPNode* curr, BasicGraph& G
             // existing_next->move = next->move;
 
             if (update_open)
-                open_list.increase(existing_next->open_handle);  // increase because f-val improved
+                open_list.increase(existing_next);  // increase because f-val improved
             if (add_to_focal)
-                existing_next->focal_handle = focal_list.push(existing_next);
+                focal_list.push(existing_next);
             if (update_in_focal)
-                focal_list.update(existing_next->focal_handle);  // should we do update? yes, because number of conflicts may go up or down
+                focal_list.update(existing_next);  // should we do update? yes, because number of conflicts may go up or down
         }
     }
     else
@@ -436,21 +541,182 @@ void SIPP::generate_node(const Interval& interval, SIPPNode* curr, BasicGraph& G
             existing_next->parent = curr;
             existing_next->depth = next->depth;
             existing_next->conflicts = conflicts;
-            existing_next->open_handle = open_list.push(existing_next);
+            existing_next->jump_dirs = next->jump_dirs;
+            open_list.push(existing_next);
             existing_next->in_openlist = true;
             if (existing_f_val <= focal_bound)
-                existing_next->focal_handle = focal_list.push(existing_next);
+                focal_list.push(existing_next);
         }
     }  // end update a node in closed list
+}
 
-    delete(next);  // not needed anymore -- we already generated it before
+bool SIPP::followHeuristic(BasicGraph& G, const SIPPNode* node, const vector<pair<int, int> >& goal_location,
+                           const ReservationTable& rt, int earliest_holding_time, Path& tail) const
+{
+    tail.clear();
+    int location = node->state.location;
+    int timestep = node->state.timestep;
+    int goal_id = node->goal_id;
+    while (true)
+    {
+        if (location == goal_location[goal_id].first)
+        {
+            if (timestep < goal_location[goal_id].second)
+                return false; // it would have to wait for the release time
+            goal_id++;
+            if (goal_id == (int)goal_location.size())
+                return timestep >= earliest_holding_time;
+            continue;
+        }
+        double distance = get_goal_distance(G, location, goal_id, goal_location);
+        int next = -1;
+        for (int dir = 0; dir < 4 && next < 0; dir++)
+        {
+            if (G.valid_move(location, dir) &&
+                get_goal_distance(G, location + G.move[dir], goal_id, goal_location) +
+                G.get_weight(location, location + G.move[dir]) <= distance + 1e-6)
+                next = location + G.move[dir];
+        }
+        if (next < 0 || rt.isConstrained(location, next, timestep + 1))
+            return false;
+        location = next;
+        timestep++;
+        tail.emplace_back(location, timestep, -1);
+    }
 }
 
+
+template <typename Open, typename Focal>
+bool SIPP::generateJumpPoints(BasicGraph& G, SIPPNode* curr, const vector<pair<int, int> >& goal_location,
+                              ReservationTable& rt, Open& open_list, Focal& focal_list)
+{
+    int location = curr->state.location;
+    int timestep = curr->state.timestep;
+    if (curr->jump_dirs == 0) // the start
+        return false;
+    for (const auto& goal : goal_location)
+    {
+        if (location == goal.first) // the search continues to the next goal in any direction
+            return false;
+    }
+    if (!isFree(location, timestep))
+        return false;
+
+    // the pruned neighbors of curr: after a vertical move, all directions but back;
+    // after a horizontal move, straight ahead and the forced neighbors
+    // The other neighbors are reached as cheaply through the previous location, which is only guaranteed
+    // along a jump: curr may be reached from a reserved location, so the paths around it are checked as well.
+    int next_dirs = curr->jump_dirs == 0xF ? 0xF : 0;
+    for (int dir = 0; dir < 4 && next_dirs != 0xF; dir++)
+    {
+        if (!((curr->jump_dirs >> dir) & 1))
+            continue;
+        int prev = location - G.move[dir];
+        if (free_times[prev] > timestep) // it might have to move back instead of waiting at prev
+            next_dirs |= 1 << ((dir + 2) % 4);
+        if (dir % 2 == 1)
+        {
+            next_dirs |= 0xF & ~(1 << ((dir + 2) % 4));
+            continue;
+        }
+        next_dirs |= 1 << dir;
+        for (int next_dir = 1; next_dir < 4; next_dir += 2)
+        {
+            if (!(G.valid_move(prev, next_dir) && G.valid_move(prev + G.move[next_dir], dir) &&
+                  free_times[prev + G.move[next_dir]] <= timestep))
+                next_dirs |= 1 << next_dir;
+        }
+    }
+    int goal = goal_location[curr->goal_id].first;
+    for (int next_dir = 0; next_dir < 4; next_dir++)
+    {
+        if (!((next_dirs >> next_dir) & 1) || !G.valid_move(location, next_dir))
+            continue;
+        int moves = jump(G, location, next_dir, timestep, goal);
+        if (moves == 0)
+            continue;
+        int next = location + moves * G.move[next_dir];
+        double h_val = get_h_value(G, next, curr->goal_id, goal_location);
+        if (h_val > INT_MAX) // This vertex cannot reach the goal vertex
+            continue;
+        int from = next - G.move[next_dir];
+        rt.forEachSafeInterval(from, next, timestep + moves, timestep + moves + 1, [&](const Interval& interval)
+        {
+            generate_node(interval, curr, G, next, timestep + moves, -1, h_val, open_list, focal_list, from);
+        });
+    }
+    return true;
+}
+
+
+int SIPP::jump(BasicGraph& G, int location, int dir, int timestep, int goal) const
+{
+    for (int moves = 1; G.valid_move(location, dir); moves++)
+    {
+        int prev = location;
+        location += G.move[dir];
+        if (location == goal || !isFree(location, timestep + moves))
+            return moves;
+        if (dir % 2 == 0) // horizontal: stop at forced neighbors (the neighbors of prev are free, see isFree)
+        {
+            for (int next_dir = 1; next_dir < 4; next_dir += 2)
+            {
+                if (G.valid_move(location, next_dir) &&
+                    !(G.valid_move(prev, next_dir) && G.valid_move(prev + G.move[next_dir], dir)))
+                    return moves;
+            }
+        }
+        else if (jump(G, location, 0, timestep + moves, goal) > 0 ||
+                 jump(G, location, 2, timestep + moves, goal) > 0) // vertical: stop where a horizontal jump ends
+        {
+            return moves;
+        }
+    }
+    return 0;
+}
+
+
+void SIPP::updateFreeTimes(BasicGraph& G, const ReservationTable& rt)
+{
+    if (free_times.size() != (size_t)G.size())
+    {
+        free_times.assign(G.size(), 0);
+        clear_times.assign(G.size(), 0);
+        reserved_locations.clear();
+    }
+    for (int location : reserved_locations)
+    {
+        free_times[location] = 0;
+        clear_times[location] = 0;
+    }
+    reserved_locations.clear();
+    rt.forEachFreeTime([&](int location, int t)
+    {
+        if (free_times[location] == 0)
+            reserved_locations.push_back(location);
+        free_times[location] = max(free_times[location], t);
+    });
+    for (size_t i = 0, n = reserved_locations.size(); i < n; i++)
+    {
+        int location = reserved_locations[i];
+        int t = free_times[location];
+        clear_times[location] = max(clear_times[location], t);
+        for (int dir = 0; dir < 4; dir++) // the neighbors that can move to location
+        {
+            int neighbor = location - G.move[dir];
+            if (neighbor < 0 || neighbor >= (int)G.size() || !G.valid_move(neighbor, dir))
+                continue;
+            if (free_times[neighbor] == 0 && clear_times[neighbor] == 0)
+                reserved_locations.push_back(neighbor);
+            clear_times[neighbor] = max(clear_times[neighbor], t - 1);
+        }
+    }
+}
+
+
 inline void SIPP::releaseClosedListNodes()
 {
-    for (auto it = allNodes_table.begin(); it != allNodes_table.end(); it++)
-        delete (*it);
-    allNodes_table.clear();
+    num_of_allocations = context.reset();
 }
 
 
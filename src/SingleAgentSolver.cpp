@@ -1,4 +1,7 @@
 #include "SingleAgentSolver.h"
+#include <mutex>
+
+static std::mutex heuristics_mutex;
 
 double SingleAgentSolver::compute_h_value(BasicGraph& G, int curr, int goal_id,
                              const vector<pair<int, int> >& goal_location) const
@@ -12,3 +15,23 @@ double SingleAgentSolver::compute_h_value(BasicGraph& G, int curr, int goal_id,
     }
     return h;
 }
+
+
+void SingleAgentSolver::prepare_heuristics(BasicGraph& G, const vector<pair<int, int> >& goal_location)
+{
+    goal_heuristics.clear();
+    goal_suffix_h.assign(goal_location.size(), 0);
+    std::lock_guard<std::mutex> lock(heuristics_mutex);
+    if (G.heuristics.memory_budget == 0)
+    {
+        goal_heuristics.resize(goal_location.size());
+        for (int i = 0; i < (int)goal_location.size(); i++)
+            goal_heuristics[i] = G.get_heuristic(goal_location[i].first);
+    }
+    for (int i = (int)goal_location.size() - 2; i >= 0; i--)
+    {
+        double h = goal_heuristics.empty() ? G.get_heuristic(goal_location[i + 1].first)[goal_location[i].first] :
+                   goal_heuristics[i + 1][goal_location[i].first];
+        goal_suffix_h[i] = h + goal_suffix_h[i + 1];
+    }
+}
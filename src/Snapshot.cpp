@@ -0,0 +1,67 @@
+#include "Snapshot.h"
+#include <cstring>
+
+
+void SnapshotWriter::write_int(int value)
+{
+    int32_t v = value;
+    data.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+
+void SnapshotWriter::write_ints(const vector<int>& values)
+{
+    write_int((int)values.size());
+    for (int value : values)
+        write_int(value);
+}
+
+
+void SnapshotWriter::write_string(const string& str)
+{
+    write_int((int)str.size());
+    data.append(str);
+}
+
+
+int SnapshotReader::read_int()
+{
+    int32_t v = 0;
+    if (fail || end - pos < (std::ptrdiff_t)sizeof(v))
+    {
+        fail = true;
+        return 0;
+    }
+    memcpy(&v, pos, sizeof(v));
+    pos += sizeof(v);
+    return v;
+}
+
+
+vector<int> SnapshotReader::read_ints()
+{
+    int n = read_int();
+    if (n < 0 || end - pos < (std::ptrdiff_t)sizeof(int32_t) * n)
+    {
+        fail = true;
+        return vector<int>();
+    }
+    vector<int> values(n);
+    for (int i = 0; i < n; i++)
+        values[i] = read_int();
+    return values;
+}
+
+
+string SnapshotReader::read_string()
+{
+    int n = read_int();
+    if (n < 0 || end - pos < n)
+    {
+        fail = true;
+        return string();
+    }
+    string str(pos, n);
+    pos += n;
+    return str;
+}
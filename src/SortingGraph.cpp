@@ -1,81 +1,44 @@
 #include "SortingGraph.h"
 #include <fstream>
-#include <boost/tokenizer.hpp>
 #include "StateTimeAStar.h"
-#include <sstream>
 #include <random>
 #include <chrono>
+#include <algorithm>
 
 bool SortingGrid::load_map(std::string fname)
 {
-    std::string line;
-    std::ifstream myfile ((fname).c_str());
-	if (!myfile.is_open())
+	if (load_snapshot(fname))
+		return true;
+	MapParser parser;
+	if (!parser.open(fname))
     {
 	    std::cout << "Map file " << fname << " does not exist. " << std::endl;
         return false;
     }
 	
     std::cout << "*** Loading map ***" << std::endl;
-    clock_t t = std::clock();
 	std::size_t pos = fname.rfind('.');      // position of the file extension
     map_name = fname.substr(0, pos);     // get the name without extension
-    getline (myfile, line); // skip the words "grid size"
-	getline(myfile, line);
-	boost::char_separator<char> sep(",");
-	boost::tokenizer< boost::char_separator<char> > tok(line, sep);
-	boost::tokenizer< boost::char_separator<char> >::iterator beg = tok.begin();
-	this->rows = atoi((*beg).c_str()); // read number of cols
-	beg++;
-	this->cols = atoi((*beg).c_str()); // read number of rows
-	move[0] = 1;
-	move[1] = -cols;
-	move[2] = -1;
-	move[3] = cols;
-
-	getline(myfile, line); // skip the headers
+    parser.skip_line(); // skip the words "grid size"
+	int rows = parser.read_int(','); // read number of rows
+	int cols = parser.read_int(','); // read number of cols
+	parser.skip_line();
+	set_size(rows, cols);
+	parser.skip_line(); // skip the headers
 
 	//read tyeps, station ids and edge weights
-	this->types.resize(rows * cols);
-	this->weights.resize(rows * cols);
-	for (int i = 0; i < rows * cols; i++)
+	read_weighted_grid(parser, true, [&](int loc, cell_type type, const MapToken& station)
 	{
-		getline(myfile, line);
-		boost::tokenizer< boost::char_separator<char> > tok(line, sep);
-		beg = tok.begin();
-		beg++; // skip id
-		this->types[i] = std::string(beg->c_str()); // read type
-		beg++;
-		if (types[i] == "Induct")
-			this->inducts[beg->c_str()] = i; // read induct station id
-		else if (types[i] == "Eject")
-		{
-			boost::unordered_map<std::string, std::list<int> >::iterator it = ejects.find(beg->c_str());
-			if (it == ejects.end())
-			{
-				this->ejects[beg->c_str()] = std::list<int>();
-			}
-			this->ejects[beg->c_str()].push_back(i); // read eject station id
-		}
-		beg++;
-		beg++; // skip x
-		beg++; // skip y
-		weights[i].resize(5);
-		for (int j = 0; j < 5; j++) // read edge weights
-		{
-			if (std::string(beg->c_str()) == "inf")
-				weights[i][j] = WEIGHT_MAX;
-			else
-				weights[i][j] = std::stod(beg->c_str());
-			beg++;
-		}
-	}
+		if (type == INDUCT)
+			this->inducts[station.to_string()] = loc; // read induct station id
+		else if (type == EJECT)
+			this->ejects[station.to_string()].push_back(loc); // read eject station id
+	});
 
-	myfile.close();
-    double runtime = (std::clock() - t) / CLOCKS_PER_SEC;
+	finish_loading(parser);
     std::cout << "Map size: " << rows << "x" << cols << " with " << inducts.size() << " induct stations and " <<
         ejects.size() << " eject stations." << std::endl;
-    std::cout << "Done! (" << runtime << " s)" << std::endl;
+    std::cout << "Done! (" << map_loading_time << " s)" << std::endl;
     return true;
 }
 
@@ -85,21 +48,13 @@ void SortingGrid::preprocessing(bool consider_rotation)
 	std::cout << "*** PreProcessing map ***" << std::endl;
 	clock_t t = std::clock();
 	this->consider_rotation = consider_rotation;
-	std::string fname;
-	if (consider_rotation)
-		fname = map_name + "_rotation_heuristics_table.txt";
-	else
-		fname = map_name + "_heuristics_table.txt";
-	std::ifstream myfile(fname.c_str());
-	bool succ = false;
-	if (myfile.is_open())
+	bool succ = load_heuristics_table();
+	if (succ)
 	{
-		succ = load_heuristics_table(myfile);
-		myfile.close();
 		// ensure that the heuristic table is correct
-		for (auto h : heuristics)
+		for (int root : heuristics.get_root_locations())
 		{
-			if (types[h.first] != "Induct" && types[h.first] != "Eject")
+			if (!has_type(root, CELL_TYPE_BIT(INDUCT) | CELL_TYPE_BIT(EJECT)))
 			{
 				cout << "The heuristic table does not match the map!" << endl;
 				exit(-1);
@@ -108,20 +63,73 @@ void SortingGrid::preprocessing(bool consider_rotation)
 	}
 	if (!succ)
 	{
+		std::vector<int> roots;
 		for (auto induct : inducts)
 		{
-			heuristics[induct.second] = compute_heuristics(induct.second);
+			roots.push_back(induct.second);
 		}
 		for (auto eject_station : ejects)
 		{
-			for (int eject : eject_station.second)
-			{
-				heuristics[eject] = compute_heuristics(eject);
-			}
+			roots.insert(roots.end(), eject_station.second.begin(), eject_station.second.end());
 		}
-		save_heuristics_table(fname);
+		precompute_heuristics(roots);
 	}
+	save_snapshot();
 
 	double runtime = (std::clock() - t) / CLOCKS_PER_SEC;
 	std::cout << "Done! (" << runtime << " s)" << std::endl;
 }
+
+
+// The stations are saved in the order of their first location and are inserted back in that order,
+// so that the hash maps are built exactly as when the map file is parsed.
+void SortingGrid::save_locations(SnapshotWriter& writer) const
+{
+	std::vector<std::pair<int, std::string> > stations;
+	for (const auto& induct : inducts)
+		stations.emplace_back(induct.second, induct.first);
+	std::sort(stations.begin(), stations.end());
+	writer.write_int((int)stations.size());
+	for (const auto& station : stations)
+	{
+		writer.write_string(station.second);
+		writer.write_int(station.first);
+	}
+
+	stations.clear();
+	for (const auto& eject : ejects)
+		stations.emplace_back(eject.second.front(), eject.first);
+	std::sort(stations.begin(), stations.end());
+	writer.write_int((int)stations.size());
+	for (const auto& station : stations)
+	{
+		writer.write_string(station.second);
+		const auto& locations = ejects.at(station.second);
+		writer.write_ints(std::vector<int>(locations.begin(), locations.end()));
+	}
+}
+
+
+bool SortingGrid::load_locations(SnapshotReader& reader)
+{
+	unordered_map<std::string, int> new_inducts;
+	unordered_map<std::string, std::list<int> > new_ejects;
+	int num_of_inducts = reader.read_int();
+	for (int i = 0; i < num_of_inducts && !reader.failed(); i++)
+	{
+		std::string station = reader.read_string();
+		new_inducts[station] = reader.read_int();
+	}
+	int num_of_ejects = reader.read_int();
+	for (int i = 0; i < num_of_ejects && !reader.failed(); i++)
+	{
+		std::string station = reader.read_string();
+		auto locations = reader.read_ints();
+		new_ejects[station] = std::list<int>(locations.begin(), locations.end());
+	}
+	if (reader.failed())
+		return false;
+	inducts.swap(new_inducts);
+	ejects.swap(new_ejects);
+	return true;
+}
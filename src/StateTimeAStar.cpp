@@ -43,13 +43,30 @@ list<pair<int, int> > StateTimeAStar::updateTrajectory(const StateTimeAStarNode*
 // after max_timestep, switch from time-space A* search to normal A* search
 Path StateTimeAStar::run(BasicGraph& G, const State& start, 
 	const vector<pair<int, int> >& goal_location, ReservationTable& rt)
+{
+    switch (get_queue_policy(G))
+    {
+    case BUCKET_QUEUE:
+        return search(G, start, goal_location, rt, context.bucket_open, context.heap_focal);
+    case DARY_HEAP_QUEUE:
+        return search(G, start, goal_location, rt, context.heap_open, context.heap_focal);
+    default:
+        return search(G, start, goal_location, rt, context.fibonacci_open, context.fibonacci_focal);
+    }
+}
+
+
+template <typename Open, typename Focal>
+Path StateTimeAStar::search(BasicGraph& G, const State& start,
+	const vector<pair<int, int> >& goal_location, ReservationTable& rt, Open& open_list, Focal& focal_list)
 {
     num_expanded = 0;
     num_generated = 0;
 	runtime = 0;
-	clock_t t = std::clock();
+	auto t = std::chrono::steady_clock::now();
 
-	double h_val = compute_h_value(G, start.location, 0, goal_location);
+	prepare_heuristics(G, goal_location);
+	double h_val = get_h_value(G, start.location, 0, goal_location);
 	if (h_val > INT_MAX)
 	{
 		cout << "The start and goal locations are disconnected!" << endl;
@@ -60,12 +77,12 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
 
 	// generate root and add it to the OPEN list
 	StateTimeAStarNode* root;
-    root = new StateTimeAStarNode(start, 0, h_val, nullptr, 0);
+    root = context.nodes.create(start, 0, h_val, nullptr, 0);
     num_generated++;
-    root->open_handle = open_list.push(root);
-    root->focal_handle = focal_list.push(root);
+    open_list.push(root);
+    focal_list.push(root);
     root->in_openlist = true;
-    allNodes_table.insert(root);
+    context.allNodes_table.insert(root);
     min_f_val = root->getFVal();
     double lower_bound = min_f_val;
 
@@ -76,7 +93,7 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
     while (!focal_list.empty())
     {
         StateTimeAStarNode* curr = focal_list.top(); focal_list.pop();
-        open_list.erase(curr->open_handle);
+        open_list.erase(curr);
         curr->in_openlist = false;
         num_expanded++;
 		
@@ -91,9 +108,7 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
 		{
 			Path path = updatePath(curr);
 			releaseClosedListNodes();
-			open_list.clear();
-			focal_list.clear();
-			runtime = (double)(std::clock() - t) / CLOCKS_PER_SEC;
+			record_search(t);
 			return path;
 		}
 
@@ -103,31 +118,30 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
             {
                 // compute cost to next_id via curr node
                 double next_g_val = curr->g_val + G.get_weight(curr->state.location, next_state.location);
-                double next_h_val = compute_h_value(G, next_state.location, curr->goal_id, goal_location);
+                double next_h_val = get_h_value(G, next_state.location, curr->goal_id, goal_location);
                 if (next_h_val >= INT_MAX) // This vertex cannot reach the goal vertex
                     continue;
-                int next_conflicts = curr->conflicts;
-				if (rt.isConflicting(curr->state.location, next_state.location, next_state.timestep))
-					next_conflicts++;
+                int next_conflicts = curr->conflicts +
+                        rt.getNumOfConflicts(curr->state.location, next_state.location, next_state.timestep);
 
-                // generate (maybe temporary) node
-                auto next = new StateTimeAStarNode(next_state, next_g_val, next_h_val, curr, next_conflicts);
+                // generate a temporary node, which is copied to the arena only if it is new
+                StateTimeAStarNode candidate(next_state, next_g_val, next_h_val, curr, next_conflicts);
+                StateTimeAStarNode* next = &candidate;
 
                 // try to retrieve it from the hash table
-                auto it = allNodes_table.find(next);
-                if (it == allNodes_table.end())
+                StateTimeAStarNode* existing_next = context.allNodes_table.find(next);
+                if (existing_next == nullptr)
                 {
-                    next->open_handle = open_list.push(next);
+                    next = context.nodes.create(candidate);
+                    open_list.push(next);
                     next->in_openlist = true;
                     num_generated++;
                     if (next->getFVal() <= lower_bound)
-                        next->focal_handle = focal_list.push(next);
-                    allNodes_table.insert(next);
+                        focal_list.push(next);
+                    context.allNodes_table.insert(next);
                 }
                 else
                 {  // update existing node's if needed (only in the open_list)
-                    StateTimeAStarNode* existing_next = *it;
-
                     if (existing_next->in_openlist)
                     {  // if its in the open list
                         if (existing_next->getFVal() > next_g_val + next_h_val ||
@@ -155,11 +169,11 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
                             // existing_next->move = next->move;
 
                             if (update_open)
-                                open_list.increase(existing_next->open_handle);  // increase because f-val improved
+                                open_list.increase(existing_next);  // increase because f-val improved
                             if (add_to_focal)
-                                existing_next->focal_handle = focal_list.push(existing_next);
+                                focal_list.push(existing_next);
                             if (update_in_focal)
-                                focal_list.update(existing_next->focal_handle);  // should we do update? yes, because number of conflicts may go up or down
+                                focal_list.update(existing_next);  // should we do update? yes, because number of conflicts may go up or down
                         }
                     }
                     else
@@ -173,13 +187,12 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
                             existing_next->parent = curr;
                             existing_next->depth = next->depth;
                             existing_next->conflicts = next_conflicts;
-                            existing_next->open_handle = open_list.push(existing_next);
+                            open_list.push(existing_next);
                             existing_next->in_openlist = true;
                             if (existing_next->getFVal() <= lower_bound)
-                                existing_next->focal_handle = focal_list.push(existing_next);
+                                focal_list.push(existing_next);
                         }
                     }  // end update a node in closed list
-                    delete(next);  // not needed anymore -- we already generated it before
                 }  // end update an existing node
             }// end if case forthe move is legal
         }  // end for loop that generates successors
@@ -192,19 +205,31 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
             // of other agents.
             auto timesteps = rt.getConstrainedTimesteps(start.location);
             auto wait_cost = G.get_weight(start.location, start.location);
-            auto h = compute_h_value(G, start.location, 0, goal_location);
+            auto h = get_h_value(G, start.location, 0, goal_location);
             for (int t : timesteps)
             {
                 State s(start.location, t, start.orientation);
-                auto node2 = new StateTimeAStarNode(s, t * wait_cost, h, root, 0);
-                num_generated++;
-                node2->open_handle = open_list.push(node2);
+                StateTimeAStarNode candidate(s, t * wait_cost, h, root, 0);
+                StateTimeAStarNode* node2 = context.allNodes_table.find(&candidate);
+                if (node2 == nullptr)
+                {
+                    node2 = context.nodes.create(candidate);
+                    num_generated++;
+                    context.allNodes_table.insert(node2);
+                }
+                else if (node2->getFVal() > candidate.getFVal() ||
+                         (node2->getFVal() == candidate.getFVal() && node2->conflicts > candidate.conflicts))
+                    *node2 = candidate; // reopen it (it is closed, as OPEN is empty)
+                else // it was expanded at least as cheaply
+                    continue;
+                open_list.push(node2);
                 node2->in_openlist = true;
-                allNodes_table.insert(node2);
             }
+            if (open_list.empty())
+                break;
             min_f_val = open_list.top()->getFVal();
             lower_bound = min_f_val;
-            open_list.top()->focal_handle = focal_list.push(open_list.top());
+            focal_list.push(open_list.top());
         }
         else
         {
@@ -214,11 +239,8 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
             {
                 double new_min_f_val = open_head->getFVal();
                 double new_lower_bound = std::max(lower_bound,  new_min_f_val);
-                for (StateTimeAStarNode* n : open_list)
-                {
-                    if (n->getFVal() > lower_bound && n->getFVal() <= new_lower_bound)
-                        n->focal_handle = focal_list.push(n);
-                }
+                open_list.for_each_in_range(lower_bound, new_lower_bound,
+                                            [&focal_list](StateTimeAStarNode* n) { focal_list.push(n); });
                 min_f_val = new_min_f_val;
                 lower_bound = new_lower_bound;
             }
@@ -228,8 +250,7 @@ Path StateTimeAStar::run(BasicGraph& G, const State& start,
 
     // no path found
     releaseClosedListNodes();
-    open_list.clear();
-    focal_list.clear();
+    record_search(t);
     return Path();
 }
 
@@ -242,17 +263,18 @@ void StateTimeAStar::findTrajectory(BasicGraph& G,
 {
     num_expanded = 0;
     num_generated = 0;
-    open_list.clear();
+    auto& open_list = context.fibonacci_open; // the travel times make the f-values fractional
     releaseClosedListNodes();
 
     // generate start and add it to the OPEN list
-    double h_val = compute_h_value(G, start.location, 0, goal_locations);
-    auto root = new StateTimeAStarNode(start, 0, h_val, nullptr, 0);
+    prepare_heuristics(G, goal_locations);
+    double h_val = get_h_value(G, start.location, 0, goal_locations);
+    auto root = context.nodes.create(start, 0, h_val, nullptr, 0);
 
     num_generated++;
-    root->open_handle = open_list.push(root);
+    open_list.push(root);
     root->in_openlist = true;
-    allNodes_table.insert(root);
+    context.allNodes_table.insert(root);
 
     while (!open_list.empty())
     {
@@ -270,7 +292,6 @@ void StateTimeAStar::findTrajectory(BasicGraph& G,
             {
                 trajectory = updateTrajectory(curr);
                 releaseClosedListNodes();
-                open_list.clear();
                 return;
             }
         }
@@ -287,45 +308,45 @@ void StateTimeAStar::findTrajectory(BasicGraph& G,
                 continue;
             // compute cost to next_id via curr node
             double next_g_val = curr->g_val + G.get_weight(curr->state.location, next_state.location) * travel_time;
-            double next_h_val = compute_h_value(G, next_state.location, curr->goal_id, goal_locations);
+            double next_h_val = get_h_value(G, next_state.location, curr->goal_id, goal_locations);
             if (next_h_val >= INT_MAX) // This vertex cannot reach the goal vertex
                 continue;
 
-            // generate (maybe temporary) node
-            auto next = new StateTimeAStarNode(next_state, next_g_val, next_h_val, curr, 0);
+            // generate a temporary node, which is copied to the arena only if it is new
+            StateTimeAStarNode candidate(next_state, next_g_val, next_h_val, curr, 0);
+            StateTimeAStarNode* next = &candidate;
 
             // try to retrieve it from the hash table
-            auto existing = allNodes_table.find(next);
-            if (existing == allNodes_table.end())
+            StateTimeAStarNode* existing = context.allNodes_table.find(next);
+            if (existing == nullptr)
             {
-                next->open_handle = open_list.push(next);
+                next = context.nodes.create(candidate);
+                open_list.push(next);
                 next->in_openlist = true;
                 num_generated++;
-                allNodes_table.insert(next);
+                context.allNodes_table.insert(next);
             }
             else
             {  // update existing node's if needed (only in the open_list)
 
-                if ((*existing)->getFVal() > next->getFVal())
+                if (existing->getFVal() > next->getFVal())
                 {
                     // update existing node
-                    (*existing)->g_val = next_g_val;
-                    (*existing)->h_val = next_h_val;
-                    (*existing)->goal_id = next->goal_id;
-                    (*existing)->parent = curr;
-                    (*existing)->depth = next->depth;
-                    if ((*existing)->in_openlist)
+                    existing->g_val = next_g_val;
+                    existing->h_val = next_h_val;
+                    existing->goal_id = next->goal_id;
+                    existing->parent = curr;
+                    existing->depth = next->depth;
+                    if (existing->in_openlist)
                     {
-                        open_list.increase((*existing)->open_handle);  // increase because f-val improved*/
+                        open_list.increase(existing);  // increase because f-val improved*/
                     }
                     else // re-open
                     {
-                        (*existing)->open_handle = open_list.push(*existing);
-                        (*existing)->in_openlist = true;
+                        open_list.push(existing);
+                        existing->in_openlist = true;
                     }
                 }
-                delete(next);  // not needed anymore -- we already generated it before
-
             }  // end update an existing node
         }  // end for loop that generates successors
     }  // end while loop
@@ -334,7 +355,5 @@ void StateTimeAStar::findTrajectory(BasicGraph& G,
 
 inline void StateTimeAStar::releaseClosedListNodes()
 {
-    for (auto it : allNodes_table)
-        delete it;
-    allNodes_table.clear();
+    num_of_allocations = context.reset();
 }
\ No newline at end of file
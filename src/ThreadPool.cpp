@@ -0,0 +1,113 @@
+#include "ThreadPool.h"
+
+
+ThreadPool::ThreadPool(int num_threads): num_threads(max(num_threads, 1)), queues(max(num_threads, 1))
+{
+    for (int i = 1; i < this->num_threads; i++)
+        workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    start_loop.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+
+void ThreadPool::parallel_for(int num_tasks, const std::function<void(int, int)>& task)
+{
+    if (num_tasks <= 0)
+        return;
+    if (num_threads == 1)
+    {
+        for (int i = 0; i < num_tasks; i++)
+            task(i, 0);
+        return;
+    }
+
+    // give each worker a contiguous block of tasks
+    for (int i = 0; i < num_threads; i++)
+    {
+        std::lock_guard<std::mutex> lock(queues[i].mutex);
+        int first = (int)((int64_t)num_tasks * i / num_threads);
+        int last = (int)((int64_t)num_tasks * (i + 1) / num_threads);
+        for (int t = first; t < last; t++)
+            queues[i].tasks.push_back(t);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current_task = &task;
+        num_of_busy_workers = num_threads - 1;
+        num_of_loops++;
+    }
+    start_loop.notify_all();
+
+    run_tasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finish_loop.wait(lock, [this] { return num_of_busy_workers == 0; });
+    current_task = nullptr;
+}
+
+
+void ThreadPool::work(int worker_id)
+{
+    uint64_t loops_done = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_loop.wait(lock, [&] { return stopped || num_of_loops != loops_done; });
+            if (stopped)
+                return;
+            loops_done = num_of_loops;
+        }
+        run_tasks(worker_id);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            num_of_busy_workers--;
+        }
+        finish_loop.notify_one();
+    }
+}
+
+
+void ThreadPool::run_tasks(int worker_id)
+{
+    int task;
+    while (pop_task(worker_id, task))
+        (*current_task)(task, worker_id);
+}
+
+
+bool ThreadPool::pop_task(int worker_id, int& task)
+{
+    {
+        TaskQueue& own = queues[worker_id];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (int i = 1; i < num_threads; i++) // steal from the others
+    {
+        TaskQueue& other = queues[(worker_id + i) % num_threads];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty())
+        {
+            task = other.tasks.front();
+            other.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -16,7 +16,6 @@ bool WHCAStar::run(const vector<State>& starts,
     num_restarts = 0;
     int num_of_agents = starts.size();
 
-    ReservationTable rt(G);
     rt.num_of_agents = num_of_agents;
     rt.map_size = G.size();
     rt.k_robust = k_robust;
@@ -27,7 +26,7 @@ bool WHCAStar::run(const vector<State>& starts,
     rt.prioritize_start = false;
     path_planner.prioritize_start = false;
 	path_planner.hold_endpoints = hold_endpoints;
-    path_planner.travel_times.clear();
+    path_planner.travel_times = nullptr;
 
     std::vector<int> priorities(num_of_agents);
     for (int i = 0; i < num_of_agents; i++)
@@ -36,6 +35,11 @@ bool WHCAStar::run(const vector<State>& starts,
     std::random_device rd;
     std::mt19937 g(rd());
 
+    // reserve the initial paths and constraints of all agents once; every restart rolls back to this state
+    initial_solution.resize(num_of_agents);
+    PrioritizedPlanner planner(G, path_planner, rt);
+    planner.init(initial_rt, initial_solution, initial_constraints);
+
     runtime = (std::clock() - start) * 1.0  / CLOCKS_PER_SEC;
     while (runtime < time_limit)
     {
@@ -46,15 +50,12 @@ bool WHCAStar::run(const vector<State>& starts,
         solution_cost = 0;
         solution = initial_solution;
         bool succ = true;
+        if (num_restarts > 1)
+            planner.restart();
         for (int i : priorities)
         {
-			rt.copy(initial_rt);
-            rt.build(solution, initial_constraints, i);
-			solution[i] = path_planner.run(G, starts[i], goal_locations[i], rt);
+			solution[i] = planner.plan(i, starts[i], goal_locations[i]);
             solution_cost += path_planner.path_cost;
-            rt.clear();
-            num_expanded += path_planner.num_expanded;
-            num_generated += path_planner.num_generated;
             runtime = (std::clock() - start) * 1.0  / CLOCKS_PER_SEC;
             if (solution[i].empty() || runtime >= time_limit)
             {
@@ -71,7 +72,7 @@ bool WHCAStar::run(const vector<State>& starts,
                 int start = starts[i].location;
                 for (const auto& goal : goal_locations[i])
                 {
-                    min_sum_of_costs += G.heuristics.at(goal.first)[start];
+                    min_sum_of_costs += G.get_heuristic(goal.first)[start];
                     start = goal.first;
                 }
             }
@@ -82,10 +83,16 @@ bool WHCAStar::run(const vector<State>& starts,
             }
             avg_path_length /= num_of_agents;
             solution_found = true;
+            num_expanded = planner.num_expanded;
+            num_generated = planner.num_generated;
+            planner.clear();
             print_results();
             return true;
         }
     }
+    num_expanded = planner.num_expanded;
+    num_generated = planner.num_generated;
+    planner.clear();
     runtime = (std::clock() - start) * 1.0  / CLOCKS_PER_SEC;
     solution_cost = -1;
     solution_found = false;
@@ -7,6 +7,7 @@
 #include "lacam.h"
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
+#include <thread>
 
 
 void set_parameters(BasicSystem& system, const boost::program_options::variables_map& vm)
@@ -23,6 +24,7 @@ void set_parameters(BasicSystem& system, const boost::program_options::variables
 	system.k_robust = vm["robust"].as<int>();
 	system.hold_endpoints = vm["hold_endpoints"].as<bool>();
 	system.useDummyPaths = vm["dummy_paths"].as<bool>();
+	system.prioritized_fallback = vm["prioritized_fallback"].as<bool>();
 	if (vm.count("seed"))
 		system.seed = vm["seed"].as<int>();
 	else
@@ -31,6 +33,30 @@ void set_parameters(BasicSystem& system, const boost::program_options::variables
 }
 
 
+// called before load_map, as the map snapshot depends on these settings
+void set_heuristic(BasicGraph& G, const boost::program_options::variables_map& vm)
+{
+	string heuristic = vm["heuristic"].as<string>();
+	if (heuristic == "SHORTEST_PATH")
+		G.heuristic = SHORTEST_PATH;
+	else if (heuristic == "MANHATTAN")
+		G.heuristic = MANHATTAN;
+	else if (heuristic == "LANDMARK")
+		G.heuristic = LANDMARK;
+	else
+	{
+		cout << "Heuristic " << heuristic << " does not exist!" << endl;
+		exit(-1);
+	}
+	G.consider_rotation = vm["rotation"].as<bool>();
+	G.num_of_landmarks = vm["landmarks"].as<int>();
+	G.heuristics.memory_budget = (size_t)(vm["heuristics_memory"].as<double>() * 1024 * 1024);
+	G.num_of_threads = vm["threads"].as<int>();
+	if (G.num_of_threads <= 0)
+		G.num_of_threads = max((int)std::thread::hardware_concurrency(), 1);
+}
+
+
 MAPFSolver* set_solver(BasicGraph& G, const boost::program_options::variables_map& vm)
 {
 	string solver_name = vm["single_agent_solver"].as<string>();
@@ -42,13 +68,29 @@ MAPFSolver* set_solver(BasicGraph& G, const boost::program_options::variables_ma
 	}
 	else if (solver_name == "SIPP")
 	{
-		path_planner = new SIPP();
+		SIPP* sipp = new SIPP();
+		sipp->windowed = vm["windowed_sipp"].as<bool>();
+		sipp->jump_points = vm["jump_points"].as<bool>();
+		sipp->validate_jump_points = vm["validate_jump_points"].as<bool>();
+		path_planner = sipp;
 	}
 	else
 	{
 		cout << "Single-agent solver " << solver_name << "does not exist!" << endl;
 		exit(-1);
 	}
+	string queue = vm["queue"].as<string>();
+	if (queue == "FIBONACCI")
+		path_planner->queue = FIBONACCI_QUEUE;
+	else if (queue == "BUCKET")
+		path_planner->queue = BUCKET_QUEUE;
+	else if (queue == "HEAP")
+		path_planner->queue = DARY_HEAP_QUEUE;
+	else
+	{
+		cout << "Queue " << queue << " does not exist!" << endl;
+		exit(-1);
+	}
 
 	solver_name = vm["solver"].as<string>();
 	if (solver_name == "ECBS")
@@ -57,6 +99,7 @@ MAPFSolver* set_solver(BasicGraph& G, const boost::program_options::variables_ma
 		ecbs->potential_function = vm["potential_function"].as<string>();
 		ecbs->potential_threshold = vm["potential_threshold"].as<double>();
 		ecbs->suboptimal_bound = vm["suboptimal_bound"].as<double>();
+		ecbs->planner_threads = max(vm["planner_threads"].as<int>(), 1);
 		mapf_solver = ecbs;
 	}
 	else if (solver_name == "PBS")
@@ -67,6 +110,7 @@ MAPFSolver* set_solver(BasicGraph& G, const boost::program_options::variables_ma
         if (vm["hold_endpoints"].as<bool>() or vm["dummy_paths"].as<bool>())
             prioritize_start = false;
         pbs->prioritize_start = prioritize_start;
+        pbs->prioritized_root = vm["prioritized_root"].as<bool>();
         pbs->setRT(vm["CAT"].as<bool>(), prioritize_start);
 		mapf_solver = pbs;
 	}
@@ -88,6 +132,17 @@ MAPFSolver* set_solver(BasicGraph& G, const boost::program_options::variables_ma
 		exit(-1);
 	}
 
+	string constraint_table = vm["constraint_table"].as<string>();
+	if (constraint_table == "HASHED")
+		mapf_solver->set_constraint_table_mode(HASHED_TABLE);
+	else if (constraint_table == "DENSE")
+		mapf_solver->set_constraint_table_mode(DENSE_TABLE);
+	else
+	{
+		cout << "Constraint table " << constraint_table << " does not exist!" << endl;
+		exit(-1);
+	}
+
 	if (vm["id"].as<bool>())
 	{
 		return new ID(G, *path_planner, *mapf_solver);
@@ -117,7 +172,27 @@ int main(int argc, char** argv)
 		("solver", po::value<string>()->default_value("PBS"), "solver (LRA, PBS, WHCA, ECBS, LaCAM)")
 		("id", po::value<bool>()->default_value(false), "independence detection")
 		("single_agent_solver", po::value<string>()->default_value("SIPP"), "single-agent solver (ASTAR, SIPP)")
+		("windowed_sipp", po::value<bool>()->default_value(false),
+				"SIPP searches only within the planning window and follows the heuristic beyond it")
+		("jump_points", po::value<bool>()->default_value(false),
+				"SIPP generates jump points instead of all neighbors where no reservations are nearby")
+		("validate_jump_points", po::value<bool>()->default_value(false),
+				"repeat every SIPP search with jump points without them and exit if the path costs differ")
+		("queue", po::value<string>()->default_value("FIBONACCI"),
+				"OPEN and FOCAL lists of the single-agent solver (FIBONACCI, BUCKET, HEAP)")
+		("heuristic", po::value<string>()->default_value("SHORTEST_PATH"),
+				"heuristic for the single-agent solver (SHORTEST_PATH, MANHATTAN, LANDMARK)")
+		("landmarks", po::value<int>()->default_value(16), "number of landmarks for the LANDMARK heuristic")
+		("heuristics_memory", po::value<double>()->default_value(0),
+				"memory budget for the heuristic tables in MB (0: unlimited)")
+		("threads", po::value<int>()->default_value(1),
+				"threads for precomputing heuristic tables (0: all hardware threads)")
+		("constraint_table", po::value<string>()->default_value("HASHED"),
+				"storage of the hard constraints in the reservation table (HASHED, DENSE)")
 		("lazyP", po::value<bool>()->default_value(false), "use lazy priority")
+		("prioritized_root", po::value<bool>()->default_value(false), "plan the PBS root node by prioritized planning")
+		("prioritized_fallback", po::value<bool>()->default_value(false),
+				"try a prioritized planning sweep before LRA* when PBS or ECBS fail")
 		("simulation_time", po::value<int>()->default_value(5000), "run simulation")
 		("simulation_window", po::value<int>()->default_value(5), "call the planner every simulation_window timesteps")
 		("travel_time_window", po::value<int>()->default_value(0), "consider the traffic jams within the given window")
@@ -136,6 +211,8 @@ int main(int argc, char** argv)
 				"Find dummy paths from Liu et al, AAMAS 2019")
 		("prioritize_start", po::value<bool>()->default_value(true), "Prioritize waiting at start locations")
 		("suboptimal_bound", po::value<double>()->default_value(1), "Suboptimal bound for ECBS")
+		("planner_threads", po::value<int>()->default_value(1),
+				"threads for the low-level searches of the two children of an ECBS split")
 		("log", po::value<bool>()->default_value(false), "save the search trees (and the priority trees)")
 		;
 	clock_t start_time = clock();
@@ -184,6 +261,7 @@ int main(int argc, char** argv)
 	if (vm["scenario"].as<string>() == "KIVA")
 	{
 		KivaGrid G;
+		set_heuristic(G, vm);
 		if (!G.load_map(vm["map"].as<std::string>()))
 			return -1;
 		MAPFSolver* solver = set_solver(G, vm);
@@ -196,6 +274,7 @@ int main(int argc, char** argv)
 	else if (vm["scenario"].as<string>() == "SORTING")
 	{
 		 SortingGrid G;
+		 set_heuristic(G, vm);
 		 if (!G.load_map(vm["map"].as<std::string>()))
 			 return -1;
 		 MAPFSolver* solver = set_solver(G, vm);
@@ -210,6 +289,7 @@ int main(int argc, char** argv)
 	else if (vm["scenario"].as<string>() == "ONLINE")
 	{
 		OnlineGrid G;
+		set_heuristic(G, vm);
 		if (!G.load_map(vm["map"].as<std::string>()))
 			return -1;
 		MAPFSolver* solver = set_solver(G, vm);
@@ -224,6 +304,7 @@ int main(int argc, char** argv)
 	else if (vm["scenario"].as<string>() == "BEE")
 	{
 		BeeGraph G;
+		set_heuristic(G, vm);
 		if (!G.load_map(vm["map"].as<std::string>()))
 			return -1;
 		MAPFSolver* solver = set_solver(G, vm);
@@ -266,6 +347,7 @@ int main(int argc, char** argv)
 	else if (vm["scenario"].as<string>() == "MT")
 	{
 		MTGrid G;
+		set_heuristic(G, vm);
 		if (!G.load_map(vm["map"].as<std::string>()))
 			return -1;
 		MAPFSolver* solver = set_solver(G, vm);